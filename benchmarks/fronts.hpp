@@ -0,0 +1,125 @@
+#ifndef MOOUTILS_BENCHMARKS_FRONTS_HPP_
+#define MOOUTILS_BENCHMARKS_FRONTS_HPP_
+
+#include <benchmark/benchmark.h>
+
+#include <mooutils/sets.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Shapes of the point sets used throughout the benchmarks. All shapes
+// assume maximization and have points in [0,1]^m, such that the zero
+// vector is a valid reference point.
+//
+// - linear: points on the simplex, i.e., sum(p) = 1.
+// - concave: points on the positive orthant of the unit sphere.
+// - convex: points on the unit sphere centered at the ideal point.
+// - random: points uniformly distributed in [0,1]^m (mostly dominated).
+enum class front_shape : int64_t { linear = 0, concave = 1, convex = 2, random = 3 };
+
+inline constexpr auto all_front_shapes = std::array{front_shape::linear, front_shape::concave,  // noformat
+                                                    front_shape::convex, front_shape::random};
+
+inline auto to_string(front_shape shape) -> std::string {
+  switch (shape) {
+    case front_shape::linear:
+      return "linear";
+    case front_shape::concave:
+      return "concave";
+    case front_shape::convex:
+      return "convex";
+    case front_shape::random:
+      return "random";
+  }
+  return "unknown";
+}
+
+// Generates `n` points with `m` objectives of a given shape. The seed
+// is fixed by default so that the same points are used in every run.
+template <typename T = double>
+auto generate_points(front_shape shape, size_t n, size_t m, uint64_t seed = 42) {
+  auto rng = std::mt19937_64(seed);
+  auto rnorm = std::normal_distribution<double>(0.0, 1.0);
+  auto rexp = std::exponential_distribution<double>(1.0);
+  auto runif = std::uniform_real_distribution<double>(0.0, 1.0);
+
+  auto points = std::vector<std::vector<T>>();
+  points.reserve(n);
+  auto aux = std::vector<double>(m);
+  for (size_t i = 0; i < n; ++i) {
+    switch (shape) {
+      case front_shape::linear: {
+        std::ranges::generate(aux, [&] { return rexp(rng); });
+        auto sum = std::accumulate(aux.begin(), aux.end(), 0.0);
+        std::ranges::for_each(aux, [sum](auto& c) { c /= sum; });
+        break;
+      }
+      case front_shape::concave:
+      case front_shape::convex: {
+        std::ranges::generate(aux, [&] { return rnorm(rng); });
+        auto norm = std::sqrt(std::inner_product(aux.begin(), aux.end(), aux.begin(), 0.0));
+        std::ranges::for_each(aux, [norm](auto& c) { c = std::abs(c) / norm; });
+        if (shape == front_shape::convex) {
+          std::ranges::for_each(aux, [](auto& c) { c = 1.0 - c; });
+        }
+        break;
+      }
+      case front_shape::random: {
+        std::ranges::generate(aux, [&] { return runif(rng); });
+        break;
+      }
+    }
+    points.emplace_back(aux.begin(), aux.end());
+  }
+  return points;
+}
+
+// Same as `generate_points` but keeps only the non-dominated points,
+// which is a requirement for some of the indicators. This only makes a
+// difference for the random shape.
+template <typename T = double>
+auto generate_front(front_shape shape, size_t n, size_t m, uint64_t seed = 42) {
+  auto points = generate_points<T>(shape, n, m, seed);
+  if (shape != front_shape::random) {
+    return points;
+  }
+  auto set = mooutils::unordered_minimal_set<std::vector<T>>();
+  for (auto& p : points) {
+    set.insert(std::move(p));
+  }
+  return std::vector<std::vector<T>>(set.begin(), set.end());
+}
+
+// Adds the arguments (shape, n, m) for all shapes, n in {1e2, ..., 1e6},
+// and m in [min_m, max_m] such that `n <= max_n(m)`. This allows to
+// bound the size of the instances for algorithms whose running time
+// grows too fast with n or m.
+template <typename MaxN>
+auto sweep(benchmark::internal::Benchmark* b, int64_t min_m, int64_t max_m, MaxN max_n) {
+  b->ArgNames({"shape", "n", "m"});
+  for (auto shape : all_front_shapes) {
+    for (int64_t m = min_m; m <= max_m; ++m) {
+      for (int64_t n = 100; n <= 1'000'000 && n <= max_n(m); n *= 10) {
+        b->Args({static_cast<int64_t>(shape), n, m});
+      }
+    }
+  }
+}
+
+// Reads the (shape, n, m) arguments added by `sweep`.
+inline auto sweep_args(benchmark::State const& state) {
+  auto shape = static_cast<front_shape>(state.range(0));
+  auto n = static_cast<size_t>(state.range(1));
+  auto m = static_cast<size_t>(state.range(2));
+  return std::tuple{shape, n, m};
+}
+
+#endif
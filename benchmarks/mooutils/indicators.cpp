@@ -0,0 +1,123 @@
+#include <mooutils/indicators.hpp>
+
+#include "fronts.hpp"
+
+#include <vector>
+
+// All hypervolume benchmarks use the zero vector as reference point,
+// which is weakly dominated by every generated point.
+
+template <typename HV>
+static void bm_hv(benchmark::State& state, HV const& hv) {
+  auto [shape, n, m] = sweep_args(state);
+  auto const front = generate_front(shape, n, m);
+  auto const r = std::vector<double>(m, 0.0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(hv(front, r));
+  }
+  state.SetLabel(to_string(shape));
+  state.counters["points"] = static_cast<double>(front.size());
+}
+
+static void bm_hv2d(benchmark::State& state) {
+  bm_hv(state, mooutils::hv2d<double>);
+}
+
+static void bm_hv3d(benchmark::State& state) {
+  bm_hv(state, mooutils::hv3d<double>);
+}
+
+static void bm_hv4d(benchmark::State& state) {
+  bm_hv(state, mooutils::hv4d<double>);
+}
+
+static void bm_hvwfg(benchmark::State& state) {
+  bm_hv(state, mooutils::hvwfg<double>);
+}
+
+static void bm_hvwfg_parallel(benchmark::State& state) {
+  bm_hv(state, mooutils::hvwfg_parallel<double>);
+}
+
+static void bm_hv_contributions2d(benchmark::State& state) {
+  bm_hv(state, mooutils::hv_contributions2d<double>);
+}
+
+static void bm_hv_contributions3d(benchmark::State& state) {
+  bm_hv(state, mooutils::hv_contributions3d<double>);
+}
+
+static void bm_hv_contributions(benchmark::State& state) {
+  bm_hv(state, mooutils::hv_contributions<double>);
+}
+
+// Selects half of the points of the front.
+template <typename Select>
+static void bm_hv_subset_select(benchmark::State& state, Select const& select) {
+  bm_hv(state, [&select](auto const& front, auto const& r) { return select(front, r, front.size() / 2); });
+}
+
+static void bm_hv_subset_select2d(benchmark::State& state) {
+  bm_hv_subset_select(state, mooutils::hv_subset_select2d<double>);
+}
+
+static void bm_hv_subset_select_forward(benchmark::State& state) {
+  bm_hv_subset_select(state, mooutils::hv_subset_select_forward<double>);
+}
+
+static void bm_hv_subset_select_backward(benchmark::State& state) {
+  bm_hv_subset_select(state, mooutils::hv_subset_select_backward<double>);
+}
+
+// Inserts every point of the front, one at a time, into an incremental
+// hypervolume structure.
+template <typename MakeHV>
+static void bm_incremental_hv(benchmark::State& state, MakeHV make_hv) {
+  auto [shape, n, m] = sweep_args(state);
+  auto const front = generate_front(shape, n, m);
+  auto const r = std::vector<double>(m, 0.0);
+  for (auto _ : state) {
+    auto hv = make_hv(r);
+    for (auto const& p : front) {
+      hv.insert(p);
+    }
+    benchmark::DoNotOptimize(hv.value());
+  }
+  state.SetLabel(to_string(shape));
+  state.counters["points"] = static_cast<double>(front.size());
+}
+
+static void bm_incremental_hv2d(benchmark::State& state) {
+  bm_incremental_hv(state, [](auto const& r) { return mooutils::incremental_hv2d<double>(r[0], r[1]); });
+}
+
+static void bm_incremental_hv3dplus(benchmark::State& state) {
+  bm_incremental_hv(state, [](auto const& r) { return mooutils::incremental_hv3dplus<double>(r[0], r[1], r[2]); });
+}
+
+static void bm_incremental_hv4dplus(benchmark::State& state) {
+  bm_incremental_hv(state,
+                    [](auto const& r) { return mooutils::incremental_hv4dplus<double>(r[0], r[1], r[2], r[3]); });
+}
+
+static void bm_incremental_hvwfg(benchmark::State& state) {
+  bm_incremental_hv(state, [](auto const& r) { return mooutils::incremental_hvwfg<double>(r); });
+}
+
+// clang-format off
+BENCHMARK(bm_hv2d)->Apply([](auto* b) { sweep(b, 2, 2, [](auto) { return 1'000'000; }); });
+BENCHMARK(bm_hv3d)->Apply([](auto* b) { sweep(b, 3, 3, [](auto) { return 100'000; }); });
+BENCHMARK(bm_hv4d)->Apply([](auto* b) { sweep(b, 4, 4, [](auto) { return 10'000; }); });
+BENCHMARK(bm_hvwfg)->Apply([](auto* b) { sweep(b, 4, 10, [](auto m) { return m <= 5 ? 1'000 : 100; }); });
+BENCHMARK(bm_hvwfg_parallel)->Apply([](auto* b) { sweep(b, 4, 10, [](auto m) { return m <= 5 ? 1'000 : 100; }); })->UseRealTime();
+BENCHMARK(bm_hv_contributions2d)->Apply([](auto* b) { sweep(b, 2, 2, [](auto) { return 1'000'000; }); });
+BENCHMARK(bm_hv_contributions3d)->Apply([](auto* b) { sweep(b, 3, 3, [](auto) { return 100'000; }); });
+BENCHMARK(bm_hv_contributions)->Apply([](auto* b) { sweep(b, 4, 6, [](auto) { return 100; }); });
+BENCHMARK(bm_hv_subset_select2d)->Apply([](auto* b) { sweep(b, 2, 2, [](auto) { return 1'000; }); });
+BENCHMARK(bm_hv_subset_select_forward)->Apply([](auto* b) { sweep(b, 2, 4, [](auto m) { return m <= 3 ? 1'000 : 100; }); });
+BENCHMARK(bm_hv_subset_select_backward)->Apply([](auto* b) { sweep(b, 2, 4, [](auto m) { return m <= 3 ? 1'000 : 100; }); });
+BENCHMARK(bm_incremental_hv2d)->Apply([](auto* b) { sweep(b, 2, 2, [](auto) { return 100'000; }); });
+BENCHMARK(bm_incremental_hv3dplus)->Apply([](auto* b) { sweep(b, 3, 3, [](auto) { return 10'000; }); });
+BENCHMARK(bm_incremental_hv4dplus)->Apply([](auto* b) { sweep(b, 4, 4, [](auto) { return 1'000; }); });
+BENCHMARK(bm_incremental_hvwfg)->Apply([](auto* b) { sweep(b, 4, 8, [](auto m) { return m <= 5 ? 1'000 : 100; }); });
+// clang-format on
@@ -0,0 +1,64 @@
+#include <mooutils/io.hpp>
+
+#include "fronts.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+static auto hvdata_file(size_t n, size_t m) -> std::filesystem::path {
+  auto path = std::filesystem::temp_directory_path() / "mooutils_bm_hvdata.dat";
+  auto const points = generate_points(front_shape::linear, n, m);
+  mooutils::write_hvdata(path, points, std::vector<double>(m, 0.0), 0.0);
+  return path;
+}
+
+// Reads a text front file with `n` points and `m` objectives, with
+// hvdata_reader or with iostreams, as a baseline.
+static void bm_hvdata_reader(benchmark::State& state) {
+  auto const n = static_cast<size_t>(state.range(0));
+  auto const m = static_cast<size_t>(state.range(1));
+  auto const path = hvdata_file(n, m);
+  for (auto _ : state) {
+    auto reader = mooutils::hvdata_reader<double>(path);
+    auto sum = 0.0;
+    for (auto const& p : reader) {
+      sum += p[0];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  std::filesystem::remove(path);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+static void bm_hvdata_istream(benchmark::State& state) {
+  auto const n = static_cast<size_t>(state.range(0));
+  auto const m = static_cast<size_t>(state.range(1));
+  auto const path = hvdata_file(n, m);
+  for (auto _ : state) {
+    auto is = std::ifstream(path);
+    auto fn = size_t{0};
+    auto fm = size_t{0};
+    auto hv = 0.0;
+    is >> fn >> fm >> hv;
+    auto reference = std::vector<double>();
+    std::copy_n(std::istream_iterator<double>(is), fm, std::back_inserter(reference));
+    auto sum = 0.0;
+    auto p = std::vector<double>(fm);
+    for (size_t i = 0; i < fn; ++i) {
+      for (auto& v : p) {
+        is >> v;
+      }
+      sum += p[0];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  std::filesystem::remove(path);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+// clang-format off
+BENCHMARK(bm_hvdata_reader)->Args({100'000, 3})->Args({100'000, 10});
+BENCHMARK(bm_hvdata_istream)->Args({100'000, 3})->Args({100'000, 10});
+// clang-format on
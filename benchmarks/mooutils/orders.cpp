@@ -0,0 +1,77 @@
+#include <mooutils/orders.hpp>
+
+#include "fronts.hpp"
+
+#include <array>
+#include <vector>
+
+// Compares `n` pairs of points, where each pair consists of two
+// consecutive points generated with a given shape. For the front shapes
+// most pairs are incomparable, while for the random shape they are a
+// mix of dominated and incomparable pairs.
+template <typename Order>
+static void bm_order(benchmark::State& state, Order const& order) {
+  auto [shape, n, m] = sweep_args(state);
+  auto const points = generate_points(shape, n + 1, m);
+  for (auto _ : state) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+      count += order(points[i], points[i + 1]) ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetLabel(to_string(shape));
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+static void bm_equivalent(benchmark::State& state) {
+  bm_order(state, mooutils::equivalent);
+}
+
+static void bm_weakly_dominates(benchmark::State& state) {
+  bm_order(state, mooutils::weakly_dominates);
+}
+
+static void bm_dominates(benchmark::State& state) {
+  bm_order(state, mooutils::dominates);
+}
+
+static void bm_strictly_dominates(benchmark::State& state) {
+  bm_order(state, mooutils::strictly_dominates);
+}
+
+static void bm_incomparable(benchmark::State& state) {
+  bm_order(state, mooutils::incomparable);
+}
+
+// Same as bm_dominates, but with points of a static size, for which
+// the comparisons are fully unrolled.
+template <size_t M>
+static void bm_dominates_static(benchmark::State& state) {
+  auto [shape, n, m] = sweep_args(state);
+  auto points = std::vector<std::array<double, M>>();
+  for (auto const& p : generate_points(shape, n + 1, M)) {
+    std::ranges::copy(p, points.emplace_back().begin());
+  }
+  for (auto _ : state) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+      count += mooutils::dominates(points[i], points[i + 1]) ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetLabel(to_string(shape));
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+static auto const all_sizes = [](auto) { return 1'000'000; };
+
+BENCHMARK(bm_equivalent)->Apply([](auto* b) { sweep(b, 2, 10, all_sizes); });
+BENCHMARK(bm_weakly_dominates)->Apply([](auto* b) { sweep(b, 2, 10, all_sizes); });
+BENCHMARK(bm_dominates)->Apply([](auto* b) { sweep(b, 2, 10, all_sizes); });
+BENCHMARK(bm_strictly_dominates)->Apply([](auto* b) { sweep(b, 2, 10, all_sizes); });
+BENCHMARK(bm_incomparable)->Apply([](auto* b) { sweep(b, 2, 10, all_sizes); });
+BENCHMARK_TEMPLATE(bm_dominates_static, 2)->Apply([](auto* b) { sweep(b, 2, 2, all_sizes); });
+BENCHMARK_TEMPLATE(bm_dominates_static, 3)->Apply([](auto* b) { sweep(b, 3, 3, all_sizes); });
+BENCHMARK_TEMPLATE(bm_dominates_static, 4)->Apply([](auto* b) { sweep(b, 4, 4, all_sizes); });
+BENCHMARK_TEMPLATE(bm_dominates_static, 8)->Apply([](auto* b) { sweep(b, 8, 8, all_sizes); });
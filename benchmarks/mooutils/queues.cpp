@@ -0,0 +1,45 @@
+#include <mooutils/queues.hpp>
+#include <mooutils/random.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Fills a random queue with `n` solutions and drains it, in batches of
+// `k` solutions with pop_n, or one at a time with pop if `k` is zero.
+template <typename Rng>
+static void bm_random_queue(benchmark::State& state) {
+  auto const n = static_cast<size_t>(state.range(0));
+  auto const k = static_cast<size_t>(state.range(1));
+  auto values = std::vector<int64_t>(n);
+  std::iota(values.begin(), values.end(), 0);
+  auto queue = mooutils::random_queue<int64_t, Rng>(Rng(42));
+  auto out = std::vector<int64_t>();
+  out.reserve(n);
+  for (auto _ : state) {
+    for (auto v : values) {
+      queue.push(v);
+    }
+    out.clear();
+    if (k == 0) {
+      while (!queue.empty()) {
+        out.push_back(queue.pop());
+      }
+    } else {
+      while (!queue.empty()) {
+        queue.pop_n(k, std::back_inserter(out));
+      }
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+// clang-format off
+BENCHMARK_TEMPLATE(bm_random_queue, std::mt19937_64)->ArgNames({"n", "k"})->ArgsProduct({{100'000}, {0, 64, 1024}});
+BENCHMARK_TEMPLATE(bm_random_queue, mooutils::xoshiro256plusplus)->ArgNames({"n", "k"})->ArgsProduct({{100'000}, {0, 64, 1024}});
+// clang-format on
@@ -0,0 +1,71 @@
+#include <mooutils/sets.hpp>
+
+#include "fronts.hpp"
+
+#include <vector>
+
+// Inserts `n` points, one at a time, into an initially empty set. For
+// the front shapes every point is accepted, which is the worst case for
+// the sets, while for the random shape most points are rejected, which
+// is the common case for an archive in a local search.
+template <typename Set>
+static void bm_set(benchmark::State& state) {
+  auto [shape, n, m] = sweep_args(state);
+  auto const points = generate_points(shape, n, m);
+  for (auto _ : state) {
+    auto set = Set();
+    for (auto const& p : points) {
+      set.insert(p);
+    }
+    benchmark::DoNotOptimize(set.size());
+  }
+  state.SetLabel(to_string(shape));
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+// Same as bm_set, but inserts all points at once with insert_range.
+template <typename Set>
+static void bm_set_insert_range(benchmark::State& state) {
+  auto [shape, n, m] = sweep_args(state);
+  auto const points = generate_points(shape, n, m);
+  for (auto _ : state) {
+    auto set = Set();
+    set.insert_range(points);
+    benchmark::DoNotOptimize(set.size());
+  }
+  state.SetLabel(to_string(shape));
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+static void bm_nondominated_filter(benchmark::State& state) {
+  auto [shape, n, m] = sweep_args(state);
+  auto const points = generate_points(shape, n, m);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(mooutils::nondominated_filter(points));
+  }
+  state.SetLabel(to_string(shape));
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+using point_type = std::vector<double>;
+using point_block_type = mooutils::dominance_block<point_type>;
+
+static auto const set_sizes = [](auto) { return 10'000; };
+
+// clang-format off
+BENCHMARK_TEMPLATE(bm_set, mooutils::unordered_minimal_set<point_type>)->Apply([](auto* b) { sweep(b, 2, 10, set_sizes); });
+BENCHMARK_TEMPLATE(bm_set, mooutils::unordered_minimal_set<point_type, point_block_type>)->Apply([](auto* b) { sweep(b, 2, 10, set_sizes); });
+BENCHMARK_TEMPLATE(bm_set, mooutils::unordered_set<point_type>)->Apply([](auto* b) { sweep(b, 2, 10, set_sizes); });
+BENCHMARK_TEMPLATE(bm_set, mooutils::flat_minimal_set<point_type>)->Apply([](auto* b) { sweep(b, 2, 10, set_sizes); });
+BENCHMARK_TEMPLATE(bm_set, mooutils::flat_minimal_set<point_type, mooutils::lexicographically_greater_fn, point_block_type>)->Apply([](auto* b) { sweep(b, 2, 10, set_sizes); });
+BENCHMARK_TEMPLATE(bm_set, mooutils::flat_set<point_type>)->Apply([](auto* b) { sweep(b, 2, 10, set_sizes); });
+BENCHMARK_TEMPLATE(bm_set, mooutils::minimal_set<point_type>)->Apply([](auto* b) { sweep(b, 2, 10, set_sizes); });
+BENCHMARK_TEMPLATE(bm_set, mooutils::set<point_type>)->Apply([](auto* b) { sweep(b, 2, 10, set_sizes); });
+BENCHMARK_TEMPLATE(bm_set, mooutils::minimal_set2d<point_type>)->Apply([](auto* b) { sweep(b, 2, 2, [](auto) { return 1'000'000; }); });
+BENCHMARK_TEMPLATE(bm_set, mooutils::nd_tree_minimal_set<point_type>)->Apply([](auto* b) { sweep(b, 2, 10, set_sizes); });
+BENCHMARK_TEMPLATE(bm_set, mooutils::quad_tree_minimal_set<point_type>)->Apply([](auto* b) { sweep(b, 2, 10, set_sizes); });
+BENCHMARK_TEMPLATE(bm_set, mooutils::concurrent_minimal_set<point_type>)->Apply([](auto* b) { sweep(b, 2, 10, set_sizes); });
+BENCHMARK_TEMPLATE(bm_set_insert_range, mooutils::flat_minimal_set<point_type>)->Apply([](auto* b) { sweep(b, 2, 10, set_sizes); });
+BENCHMARK_TEMPLATE(bm_set_insert_range, mooutils::minimal_set<point_type>)->Apply([](auto* b) { sweep(b, 2, 10, set_sizes); });
+BENCHMARK(bm_nondominated_filter)->Apply([](auto* b) { sweep(b, 2, 10, [](auto) { return 100'000; }); });
+// clang-format on
@@ -0,0 +1,42 @@
+#include <mooutils/sorting.hpp>
+
+#include "fronts.hpp"
+
+#include <vector>
+
+// The linear, concave, and convex shapes consist of a single front,
+// which is the worst case for most algorithms, while the random shape
+// has many fronts.
+template <typename Sort>
+static void bm_sort(benchmark::State& state, Sort const& sort) {
+  auto [shape, n, m] = sweep_args(state);
+  auto const points = generate_points(shape, n, m);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sort(points));
+  }
+  state.SetLabel(to_string(shape));
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+static void bm_nondominated_sort(benchmark::State& state) {
+  bm_sort(state, mooutils::nondominated_sort);
+}
+
+static void bm_nondominated_sort_dc(benchmark::State& state) {
+  bm_sort(state, mooutils::nondominated_sort_dc);
+}
+
+static void bm_nondominated_sort_ens_ss(benchmark::State& state) {
+  bm_sort(state, mooutils::nondominated_sort_ens_ss);
+}
+
+static void bm_nondominated_sort_ens_bs(benchmark::State& state) {
+  bm_sort(state, mooutils::nondominated_sort_ens_bs);
+}
+
+// clang-format off
+BENCHMARK(bm_nondominated_sort)->Apply([](auto* b) { sweep(b, 2, 10, [](auto) { return 100'000; }); });
+BENCHMARK(bm_nondominated_sort_dc)->Apply([](auto* b) { sweep(b, 2, 10, [](auto) { return 100'000; }); });
+BENCHMARK(bm_nondominated_sort_ens_ss)->Apply([](auto* b) { sweep(b, 2, 10, [](auto) { return 10'000; }); });
+BENCHMARK(bm_nondominated_sort_ens_bs)->Apply([](auto* b) { sweep(b, 2, 10, [](auto) { return 10'000; }); });
+// clang-format on
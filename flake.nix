@@ -29,6 +29,7 @@
             ninja
             doxygen
             catch2
+            gbenchmark
           ];
         };
 
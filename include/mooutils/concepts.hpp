@@ -2,7 +2,10 @@
 #define MOOUTILS_CONCEPTS_HPP_
 
 #include <concepts>
+#include <cstddef>
 #include <ranges>
+#include <span>
+#include <tuple>
 #include <type_traits>
 
 namespace mooutils {
@@ -90,6 +93,29 @@ concept is_constraint_vector_set =
   std::ranges::common_range<T> &&
   is_or_has_constraint_vector<std::ranges::range_value_t<T>>;
 
+// clang-format on
+
+/**
+ * \brief Number of values of a range known at compile time.
+ *
+ * This is N for std::array<T, N>, std::span<T, N>, and other types with
+ * a std::tuple_size, or std::dynamic_extent otherwise. It allows
+ * selecting algorithms for a given number of objectives at compile
+ * time.
+ */
+template <typename T>
+struct static_extent : std::integral_constant<size_t, std::dynamic_extent> {};
+
+template <typename T>
+  requires requires { std::tuple_size<T>::value; }
+struct static_extent<T> : std::integral_constant<size_t, std::tuple_size<T>::value> {};
+
+template <typename T, size_t N>
+struct static_extent<std::span<T, N>> : std::integral_constant<size_t, N> {};
+
+template <typename T>
+inline constexpr size_t static_extent_v = static_extent<std::remove_cvref_t<T>>::value;
+
 }  // namespace mooutils
 
 #endif
@@ -6,12 +6,23 @@
 #include "sets.hpp"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <limits>
 #include <list>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <numeric>
+#include <optional>
 #include <set>
 #include <span>
+#include <thread>
 #include <type_traits>
 #include <variant>
 #include <vector>
@@ -37,8 +48,11 @@ struct hv2d_fn {
       auto res = T{0};
       auto aux = std::array<T, 2>{r[0], r[1]};
       for (auto const& v : objective_vectors(set)) {
-        res += (v[0] - aux[0]) * (v[1] - aux[1]);
-        aux[1] = v[1];
+        // Skip points dominated by the ones before them
+        if (v[1] > aux[1]) {
+          res += (v[0] - aux[0]) * (v[1] - aux[1]);
+          aux[1] = v[1];
+        }
       }
       return res;
     } else {
@@ -72,38 +86,7 @@ struct hv3d_fn {
   template <is_objective_vector_set S, is_objective_vector R>
   [[nodiscard]] constexpr auto operator()(S const& set, R const& r, bool sorted = false) const -> T {
     if (sorted) {
-      using array2_t = std::array<T, 2>;
-
-      auto aux = std::vector<array2_t>{{r[1], std::numeric_limits<T>::max()}, {std::numeric_limits<T>::max(), r[2]}};
-
-      auto v = T{0};
-      auto a = T{0};
-      auto z = T{0};
-
-      for (auto const& p : objective_vectors(set)) {
-        v += a * (z - p[0]);
-        z = p[0];
-
-        auto tmp = array2_t{p[1], p[2]};
-        auto it = std::lower_bound(aux.begin(), aux.end(), tmp,
-                                   [](auto const& lhs, auto const& rhs) { return lhs[1] > rhs[1]; });
-        auto jt = it;
-
-        auto ref = array2_t{(*std::prev(it))[0], tmp[1]};
-        for (; (*it)[0] <= tmp[0]; ++it) {
-          a += (tmp[0] - ref[0]) * (ref[1] - (*it)[1]);
-          ref = *it;
-        }
-        a += (tmp[0] - ref[0]) * (ref[1] - (*it)[1]);
-        if (jt != it) {
-          *jt = tmp;
-          aux.erase(++jt, it);
-        } else {
-          aux.insert(it, tmp);
-        }
-      }
-      v += a * (z - r[0]);
-      return v;
+      return sweep(set, r);
     } else {
       auto ovs = objective_vectors(set);
       using ov_type = std::array<T, 3>;
@@ -116,96 +99,520 @@ struct hv3d_fn {
       return operator()(std::move(sorted_set), r, true);
     }
   }
+
+ private:
+  using array2_t = std::array<T, 2>;
+
+  // Once the 2D front of the sweep has more than this many points, it
+  // is moved from a vector to a balanced tree, such that the whole
+  // sweep takes O(n log n) time. Small fronts, which are the common
+  // case, are faster to update in a vector.
+  static constexpr size_t tree_threshold = 2048;
+
+  struct front_compare {
+    [[nodiscard]] constexpr auto operator()(array2_t const& lhs, array2_t const& rhs) const -> bool {
+      return lhs[1] > rhs[1];
+    }
+  };
+
+  template <is_objective_vector_set S, is_objective_vector R>
+  [[nodiscard]] static auto sweep(S const& set, R const& r) -> T {
+    auto front = std::vector<array2_t>{{r[1], std::numeric_limits<T>::max()}, {std::numeric_limits<T>::max(), r[2]}};
+
+    // The tree nodes are allocated from a monotonic buffer, since at
+    // most n+2 of them are ever alive
+    auto resource = std::pmr::monotonic_buffer_resource();
+    auto tree = std::pmr::set<array2_t, front_compare>(&resource);
+
+    auto v = T{0};
+    auto a = T{0};
+    auto z = T{0};
+
+    for (auto const& p : objective_vectors(set)) {
+      v += a * (z - p[0]);
+      z = p[0];
+
+      auto tmp = array2_t{p[1], p[2]};
+      if (tree.empty()) {
+        a += update(front, tmp);
+        if (front.size() > tree_threshold) {
+          tree.insert(front.begin(), front.end());
+          front = std::vector<array2_t>();
+        }
+      } else {
+        a += update(tree, tmp);
+      }
+    }
+    v += a * (z - r[0]);
+    return v;
+  }
+
+  // Inserts p in the front, removing the points it dominates, and
+  // returns the area it adds. Since the points are swept in decreasing
+  // order of the first objective, a point weakly dominated by the front
+  // adds nothing and is skipped.
+  template <typename Front>
+  [[nodiscard]] static constexpr auto update(Front& front, array2_t const& p) -> T {
+    auto it = front.begin();
+    if constexpr (std::ranges::random_access_range<Front>) {
+      it = std::lower_bound(front.begin(), front.end(), p, front_compare{});
+    } else {
+      it = front.lower_bound(p);
+    }
+
+    auto const& q = (*it)[1] == p[1] ? *it : *std::prev(it);
+    if (q[0] >= p[0]) {
+      return T{0};
+    }
+
+    auto jt = it;
+    auto a = T{0};
+    auto ref = array2_t{(*std::prev(it))[0], p[1]};
+    for (; (*it)[0] <= p[0]; ++it) {
+      a += (p[0] - ref[0]) * (ref[1] - (*it)[1]);
+      ref = *it;
+    }
+    a += (p[0] - ref[0]) * (ref[1] - (*it)[1]);
+
+    if (jt == it) {
+      front.insert(it, p);
+    } else if constexpr (std::ranges::random_access_range<Front>) {
+      *jt = p;
+      front.erase(++jt, it);
+    } else {
+      front.insert(front.erase(jt, it), p);
+    }
+    return a;
+  }
 };
 
 template <typename T>
 inline constexpr hv3d_fn<T> hv3d;
 
+template <typename Value, typename Allocator = std::allocator<Value>>
+class incremental_hv3dplus;
+
+// HV4D+ algorithm from "A. P. Guerreiro and C. M. Fonseca, "Computing
+// and Updating Hypervolume Contributions in Up to Four Dimensions," in
+// IEEE Transactions on Evolutionary Computation, vol. 22, no. 3, pp.
+// 449-463, June 2018, doi: 10.1109/TEVC.2017.2729550."
+//
+// Sweeps the points in decreasing order of the first objective, and
+// keeps the volume dominated by the projections of the points swept so
+// far (on the remaining objectives) with an incremental_hv3dplus
+// structure. Runs in O(n^2) time.
 template <typename T>
-struct hvwfg_fn {
+struct hv4d_fn {
   template <is_or_has_objective_vector V, is_objective_vector R>
   [[nodiscard]] constexpr auto operator()(V const& v, R const& r) const -> T {
     auto const& ov = objective_vector(v);
-    assert(mooutils::weakly_dominates(ov, r));
-    assert(ov.size() > 1);
-    assert(r.size() == ov.size());
-    return std::transform_reduce(ov.begin(), ov.end(), r.begin(), T{1}, std::multiplies<T>{}, std::minus<T>{});
+    assert(ov[0] >= r[0]);
+    assert(ov[1] >= r[1]);
+    assert(ov[2] >= r[2]);
+    assert(ov[3] >= r[3]);
+    return T{(ov[0] - r[0])} * T{(ov[1] - r[1])} * T{(ov[2] - r[2])} * T{(ov[3] - r[3])};
   }
 
   template <is_objective_vector_set S, is_objective_vector R>
   [[nodiscard]] constexpr auto operator()(S const& set, R const& r, bool sorted = false) const -> T {
     if (sorted) {
-      return this->wfg(set, r, T{1});
+      using array3_t = std::array<T, 3>;
+
+      auto hv3d = incremental_hv3dplus<T>(r[1], r[2], r[3]);
+
+      auto v = T{0};
+      auto a = T{0};
+      auto z = T{0};
+
+      for (auto const& p : objective_vectors(set)) {
+        v += a * (z - p[0]);
+        z = p[0];
+        a += hv3d.insert(array3_t{p[1], p[2], p[3]});
+      }
+      v += a * (z - r[0]);
+      return v;
     } else {
       auto ovs = objective_vectors(set);
-      using ov_type = std::ranges::range_value_t<decltype(ovs)>;
-      auto sorted_set = std::vector<ov_type>(ovs.begin(), ovs.end());
+      using ov_type = std::array<T, 4>;
+      auto sorted_set = std::vector<ov_type>();
+      sorted_set.reserve(set.size());
+      for (auto const& v : ovs) {
+        sorted_set.push_back(ov_type{v[0], v[1], v[2], v[3]});
+      }
       std::ranges::sort(sorted_set, lexicographically_greater_fn{});
       return operator()(std::move(sorted_set), r, true);
     }
   }
+};
 
- protected:
-  template <is_objective_vector_set S, is_or_has_objective_vector V>
-  [[nodiscard]] constexpr auto limitset(S const& set, V const& v) const {
-    auto const& ov = objective_vector(v);
-    auto const& ovs = objective_vectors(set);
-    using ov_type = std::vector<T>;  // std::ranges::range_value_t<decltype(ovs)>;
-    std::vector<ov_type> tmp;
-    tmp.reserve(set.size());
-    auto res = flat_minimal_set<ov_type>(std::move(tmp));
-    for (auto const& p : ovs) {
-      auto aux = ov_type();
-      aux.reserve(p.size());
-      std::transform(ov.begin(), ov.end(), p.begin(), std::back_inserter(aux),
-                     [](auto const& in1, auto const& in2) { return in1 < in2 ? in1 : in2; });
-      res.insert(std::move(aux));
+template <typename T>
+inline constexpr hv4d_fn<T> hv4d;
+
+// Scratch space for the WFG algorithm.
+//
+// All the memory required to compute the hypervolume (or an exclusive
+// hypervolume contribution) of a set with at most `n` points and `m`
+// objectives is allocated upfront, such that no allocations are made
+// during the computation itself. Points are stored contiguously in a
+// single arena, where each level of the recursion (indexed by its
+// number of objectives d) has its own region for: the set whose
+// hypervolume is being computed at that level (`set`), the points
+// already processed by the level above, projected to d objectives
+// (`newset`), and the limited points before being sorted and filtered
+// (`limit`).
+//
+// Each call to `hv` or `exclhv` grows the workspace if needed, so a
+// workspace can be reused across calls (see incremental_hvwfg).
+template <typename T>
+class hvwfg_workspace {
+ public:
+  using size_type = std::size_t;
+
+  hvwfg_workspace() = default;
+
+  hvwfg_workspace(size_type n, size_type m) {
+    reserve(n, m);
+  }
+
+  // Makes sure that there is enough space for sets with `n` points and
+  // `m` objectives.
+  constexpr auto reserve(size_type n, size_type m) -> void {
+    assert(m > 1);
+    if (n <= m_n && m == m_m) {
+      return;
+    }
+    // Grow geometrically, so that a workspace reused for increasingly
+    // larger sets is reallocated only a logarithmic number of times.
+    m_n = std::max(n, 2 * m_n);
+    m_m = m;
+    m_levels.resize(m + 1);
+    auto offset = size_type{0};
+    for (size_type d = 2; d <= m; ++d) {
+      auto& lv = m_levels[d];
+      lv.set = offset;
+      lv.newset = offset + m_n * d;
+      lv.limit = offset + 2 * m_n * d;
+      lv.index = (d - 2) * m_n;
+      offset += 3 * m_n * d;
+    }
+    m_data.resize(offset + 2 * m);
+    m_index.resize((m - 1) * m_n);
+    m_front.resize(m_n + 2);
+  }
+
+  // Hypervolume of `set` w.r.t. reference point `r`. If `sorted` is
+  // true, `set` must be sorted in lexicographically decreasing order.
+  // Dominated points are discarded before the computation.
+  template <is_objective_vector_set S, is_objective_vector R>
+  [[nodiscard]] constexpr auto hv(S const& set, R const& r, bool sorted = false) -> T {
+    load(set, r, sorted);
+    return wfg(std::ranges::size(r), T{1});
+  }
+
+  // Exclusive hypervolume contributions of every point in `set` w.r.t.
+  // reference point `r`, in the same order as the points in `set`. The
+  // contribution of a point is computed w.r.t. all other points, so
+  // dominated and duplicated points are taken into account.
+  template <is_objective_vector_set S, is_objective_vector R>
+  [[nodiscard]] constexpr auto contributions(S const& set, R const& r) -> std::vector<T> {
+    auto n = std::ranges::size(set);
+    auto m = std::ranges::size(r);
+    reserve(n, m);
+    load_reference(r);
+
+    auto points = std::vector<T>();
+    points.reserve(n * m);
+    for (auto const& p : objective_vectors(set)) {
+      points.insert(points.end(), std::ranges::begin(p), std::ranges::end(p));
+    }
+
+    auto res = std::vector<T>(n, T{0});
+    auto* limit = m_data.data() + m_levels[m].limit;
+    for (size_type i = 0; i < n; ++i) {
+      auto* p = row(points.data(), i, m);
+      auto k = size_type{0};
+      for (size_type j = 0; j < n; ++j) {
+        if (j != i) {
+          auto* q = row(points.data(), j, m);
+          std::transform(q, q + m, p, limit + k * m, [](T const& a, T const& b) { return a < b ? a : b; });
+          ++k;
+        }
+      }
+      sort_and_filter(m, k);
+      res[i] = box(p, m) - wfg(m, T{1});
     }
     return res;
   }
 
+  // Exclusive hypervolume contribution of `v` to `set` w.r.t. reference
+  // point `r`. The set does not need to be sorted.
   template <is_objective_vector_set S, is_or_has_objective_vector V, is_objective_vector R>
-  [[nodiscard]] constexpr auto exclhv(S const& set, V const& v, R const& r, T c) const -> T {
-    return c * operator()(v, r) - this->wfg(limitset(set, v), r, c);
+  [[nodiscard]] constexpr auto exclhv(S const& set, V const& v, R const& r) -> T {
+    auto m = std::ranges::size(r);
+    reserve(std::ranges::size(set), m);
+    load_reference(r);
+
+    auto* p = m_data.data() + m_data.size() - m;
+    std::ranges::copy(objective_vector(v), p);
+
+    auto& lv = m_levels[m];
+    auto* limit = m_data.data() + lv.limit;
+    auto k = size_type{0};
+    for (auto const& q : objective_vectors(set)) {
+      std::transform(std::ranges::begin(q), std::ranges::end(q), p, limit + k * m,
+                     [](T const& a, T const& b) { return a < b ? a : b; });
+      ++k;
+    }
+    sort_and_filter(m, k);
+
+    return box(p, m) - wfg(m, T{1});
   }
 
-  // TODO this currently does not support array like containers.
+ private:
+  template <typename>
+  friend struct hvwfg_parallel_fn;
+
+  struct level {
+    size_type set = 0;
+    size_type newset = 0;
+    size_type limit = 0;
+    size_type index = 0;
+    size_type set_size = 0;
+    size_type newset_size = 0;
+  };
+
+  // Loads the sorted non-dominated points of `set` into the `set`
+  // region of the top level, and the reference point.
   template <is_objective_vector_set S, is_objective_vector R>
-  [[nodiscard]] constexpr auto wfg(S const& set, R const& r, T c) const -> T {
-    auto size = r.size();
-    if (size == 2) {
-      return c * hv2d<T>(set, r, true);
-    } else if (size == 3) {
-      return c * hv3d<T>(set, r, true);
-    } else {
-      auto ovs = objective_vectors(set);
-      using ov_type = std::ranges::range_value_t<decltype(ovs)>;
+  constexpr auto load(S const& set, R const& r, bool sorted) -> void {
+    auto m = std::ranges::size(r);
+    reserve(std::ranges::size(set), m);
+    load_reference(r);
+
+    auto& lv = m_levels[m];
+    auto* limit = m_data.data() + lv.limit;
+    auto k = size_type{0};
+    for (auto const& p : objective_vectors(set)) {
+      std::ranges::copy(p, limit + k * m);
+      ++k;
+    }
+    sort_and_filter(m, k, sorted);
+  }
 
-      auto tmp = std::vector<ov_type>();
-      tmp.reserve(set.size());
-      auto newset = flat_minimal_set<ov_type>(std::move(tmp));
+  template <typename R>
+  constexpr auto load_reference(R const& r) -> void {
+    // The reference point is kept right before the scratch point used
+    // by exclhv, at the end of the arena.
+    std::ranges::copy(r, m_data.data() + m_data.size() - 2 * m_m);
+  }
 
-      auto newr = std::span(r.begin() + 1, r.end());
+  // Reference point for a level with d objectives (the last d
+  // coordinates of the original reference point).
+  [[nodiscard]] constexpr auto reference(size_type d) const -> T const* {
+    return m_data.data() + m_data.size() - m_m - d;
+  }
 
-      auto v = T{0};
-      for (auto const& p : ovs) {
-        auto newc = c * (p[0] - r[0]);
-        // TODO See if we can use a std::span to avoid copying
-        auto newp = ov_type(p.begin() + 1, p.end());
-        v += this->exclhv(newset, newp, newr, newc);
-        newset.insert(std::move(newp));
+  [[nodiscard]] static constexpr auto row(T* rows, size_type i, size_type d) -> T* {
+    return rows + i * d;
+  }
+
+  [[nodiscard]] static constexpr auto weakly_dominates_row(T const* a, T const* b, size_type d) -> bool {
+    return mooutils::weakly_dominates(std::span(a, d), std::span(b, d));
+  }
+
+  // Sorts the indices of the first k rows in lexicographically
+  // decreasing order of the rows.
+  static constexpr auto sort_rows(T const* rows, size_type* index, size_type k, size_type d) -> void {
+    std::sort(index, index + k, [rows, d](auto i, auto j) {
+      auto a = rows + i * d;
+      auto b = rows + j * d;
+      return std::lexicographical_compare(b, b + d, a, a + d);
+    });
+  }
+
+  // Volume of the box between point p and the reference point, for a
+  // level with d objectives.
+  [[nodiscard]] constexpr auto box(T const* p, size_type d) const -> T {
+    auto r = reference(d);
+    return std::transform_reduce(p, p + d, r, T{1}, std::multiplies<T>{}, std::minus<T>{});
+  }
+
+  // Sorts the first k rows of the `limit` region of level d, and copies
+  // the non-dominated ones to the `set` region. If `sorted` is true the
+  // rows are assumed to be already sorted.
+  constexpr auto sort_and_filter(size_type d, size_type k, bool sorted = false) -> void {
+    auto& lv = m_levels[d];
+    auto* limit = m_data.data() + lv.limit;
+    auto* index = m_index.data() + lv.index;
+    auto* out = m_data.data() + lv.set;
+
+    std::iota(index, index + k, size_type{0});
+    if (!sorted) {
+      sort_rows(limit, index, k, d);
+    }
+
+    // Since rows are sorted in decreasing lexicographical order, a row
+    // can only be weakly dominated by the ones before it.
+    auto size = size_type{0};
+    for (size_type i = 0; i < k; ++i) {
+      auto* p = row(limit, index[i], d);
+      auto dominated = false;
+      for (size_type j = 0; j < size && !dominated; ++j) {
+        dominated = weakly_dominates_row(row(out, j, d), p, d);
       }
+      if (!dominated) {
+        std::copy_n(p, d, row(out, size++, d));
+      }
+    }
+    lv.set_size = size;
+  }
 
-      return v;
+  // Inserts p into the `newset` region of level d, keeping only the
+  // non-dominated points.
+  constexpr auto insert_newset(size_type d, T const* p) -> void {
+    auto& lv = m_levels[d];
+    auto* rows = m_data.data() + lv.newset;
+    for (size_type i = 0; i < lv.newset_size; ++i) {
+      if (weakly_dominates_row(row(rows, i, d), p, d)) {
+        return;
+      }
+    }
+    auto size = size_type{0};
+    for (size_type i = 0; i < lv.newset_size; ++i) {
+      if (!weakly_dominates_row(p, row(rows, i, d), d)) {
+        if (size != i) {
+          std::copy_n(row(rows, i, d), d, row(rows, size, d));
+        }
+        ++size;
+      }
     }
+    std::copy_n(p, d, row(rows, size++, d));
+    lv.newset_size = size;
   }
-};
 
-template <typename T>
-inline constexpr hvwfg_fn<T> hvwfg;
+  // Limit set of the projection of row i of `rows` (with d objectives)
+  // w.r.t. the projections of the rows before it, stored in the `set`
+  // region of level d - 1. This is the same set as the one computed by
+  // `exclhv` in the loop of `wfg`, since limiting dominated points can
+  // only result in dominated points.
+  constexpr auto limit_prefix(T const* rows, size_type i, size_type d) -> void {
+    auto* limit = m_data.data() + m_levels[d - 1].limit;
+    auto p = rows + i * d + 1;
+    for (size_type j = 0; j < i; ++j) {
+      auto q = rows + j * d + 1;
+      auto l = row(limit, j, d - 1);
+      for (size_type k = 0; k < d - 1; ++k) {
+        l[k] = q[k] < p[k] ? q[k] : p[k];
+      }
+    }
+    sort_and_filter(d - 1, i);
+  }
+
+  // Exclusive hypervolume of p w.r.t. the `newset` of level d,
+  // multiplied by c.
+  constexpr auto exclhv(size_type d, T const* p, T c) -> T {
+    auto& lv = m_levels[d];
+    auto* rows = m_data.data() + lv.newset;
+    auto* limit = m_data.data() + lv.limit;
+    for (size_type i = 0; i < lv.newset_size; ++i) {
+      auto q = row(rows, i, d);
+      auto l = row(limit, i, d);
+      for (size_type j = 0; j < d; ++j) {
+        l[j] = q[j] < p[j] ? q[j] : p[j];
+      }
+    }
+    sort_and_filter(d, lv.newset_size);
+    return c * box(p, d) - wfg(d, c);
+  }
+
+  // Hypervolume of the `set` of level d multiplied by c.
+  constexpr auto wfg(size_type d, T c) -> T {
+    auto& lv = m_levels[d];
+    auto* set = m_data.data() + lv.set;
+    if (d == 2) {
+      return c * hv2d(set, lv.set_size);
+    } else if (d == 3) {
+      return c * hv3d(set, lv.set_size);
+    }
+
+    auto r = reference(d);
+    m_levels[d - 1].newset_size = 0;
+    auto v = T{0};
+    for (size_type i = 0; i < lv.set_size; ++i) {
+      auto p = row(set, i, d);
+      v += exclhv(d - 1, p + 1, c * (p[0] - r[0]));
+      insert_newset(d - 1, p + 1);
+    }
+    return v;
+  }
+
+  // Same as hv2d_fn for k sorted and non-dominated rows.
+  [[nodiscard]] constexpr auto hv2d(T const* rows, size_type k) const -> T {
+    auto r = reference(2);
+    auto res = T{0};
+    auto aux = r[1];
+    for (size_type i = 0; i < k; ++i) {
+      auto p = rows + i * 2;
+      res += (p[0] - r[0]) * (p[1] - aux);
+      aux = p[1];
+    }
+    return res;
+  }
+
+  // Same as hv3d_fn for k sorted and non-dominated rows, using a
+  // preallocated buffer for the 2D front.
+  [[nodiscard]] constexpr auto hv3d(T const* rows, size_type k) -> T {
+    using array2_t = std::array<T, 2>;
+    auto r = reference(3);
+    auto* front = m_front.data();
+    front[0] = array2_t{r[1], std::numeric_limits<T>::max()};
+    front[1] = array2_t{std::numeric_limits<T>::max(), r[2]};
+    auto size = size_type{2};
+
+    auto v = T{0};
+    auto a = T{0};
+    auto z = T{0};
+
+    for (size_type i = 0; i < k; ++i) {
+      auto p = rows + i * 3;
+      v += a * (z - p[0]);
+      z = p[0];
+
+      auto tmp = array2_t{p[1], p[2]};
+      auto it = std::lower_bound(front, front + size, tmp,
+                                 [](auto const& lhs, auto const& rhs) { return lhs[1] > rhs[1]; });
+      auto jt = it;
+
+      auto ref = array2_t{(*std::prev(it))[0], tmp[1]};
+      for (; (*it)[0] <= tmp[0]; ++it) {
+        a += (tmp[0] - ref[0]) * (ref[1] - (*it)[1]);
+        ref = *it;
+      }
+      a += (tmp[0] - ref[0]) * (ref[1] - (*it)[1]);
+      if (jt != it) {
+        *jt = tmp;
+        auto last = std::copy(it, front + size, std::next(jt));
+        size = static_cast<size_type>(last - front);
+      } else {
+        std::copy_backward(it, front + size, front + size + 1);
+        *it = tmp;
+        ++size;
+      }
+    }
+    v += a * (z - r[0]);
+    return v;
+  }
+
+  size_type m_n = 0;
+  size_type m_m = 0;
+  std::vector<level> m_levels;
+  std::vector<T> m_data;
+  std::vector<size_type> m_index;
+  std::vector<std::array<T, 2>> m_front;
+};
 
 template <typename T>
-struct hv_fn {
+struct hvwfg_fn {
   template <is_or_has_objective_vector V, is_objective_vector R>
   [[nodiscard]] constexpr auto operator()(V const& v, R const& r) const -> T {
     auto const& ov = objective_vector(v);
@@ -217,91 +624,551 @@ struct hv_fn {
 
   template <is_objective_vector_set S, is_objective_vector R>
   [[nodiscard]] constexpr auto operator()(S const& set, R const& r, bool sorted = false) const -> T {
-    if (r.size() == 2) {
+    auto m = std::ranges::size(r);
+    if (m == 2) {
       return hv2d<T>(set, r, sorted);
-    } else if (r.size() == 3) {
+    } else if (m == 3) {
       return hv3d<T>(set, r, sorted);
-    } else {
-      return hvwfg<T>(set, r, sorted);
     }
+    auto workspace = hvwfg_workspace<T>(std::ranges::size(set), m);
+    return workspace.hv(set, r, sorted);
+  }
+
+ protected:
+  template <is_objective_vector_set S, is_or_has_objective_vector V, is_objective_vector R>
+  [[nodiscard]] constexpr auto exclhv(S const& set, V const& v, R const& r, T c) const -> T {
+    auto workspace = hvwfg_workspace<T>(std::ranges::size(set), std::ranges::size(r));
+    return c * workspace.exclhv(set, v, r);
   }
 };
 
 template <typename T>
-inline constexpr hv_fn<T> hv;
+inline constexpr hvwfg_fn<T> hvwfg;
 
-// Pure virtual class for quality indicator structures that allow for
-// incrementally updating a quality indicator with respect to the
-// insertion of new solutions into the set.
+// Multithreaded version of hvwfg_fn.
 //
-// TODO allow initializing with a set of existing solutions (and
-// optionally their hypervolume).
-template <typename Value, typename Solution>
-class increment_indicator {
- public:
-  using value_type = Value;
-  using solution_type = Solution;
+// The exclusive contributions computed in the top level loop of the WFG
+// algorithm only depend on the points that come before them, so they
+// are computed as independent tasks by a pool of threads with work
+// stealing. Large subproblems (limit sets with at least `split_size`
+// points and 4 or more objectives) are split again into tasks in the
+// same way. The results are reduced at the end in the same order as in
+// hvwfg_fn, so the result does not depend on the number of threads and
+// is the same as the one of hvwfg_fn.
+template <typename T>
+struct hvwfg_parallel_fn {
+  using size_type = std::size_t;
 
-  // Get the current indicator value.
-  virtual auto value() const -> value_type = 0;
+  // Minimum number of points of a subproblem for it to be split.
+  static constexpr size_type split_size = 32;
 
-  // Find the contribution of a solution.
-  virtual auto contribution(solution_type const& s) const -> value_type = 0;
+  template <is_or_has_objective_vector V, is_objective_vector R>
+  [[nodiscard]] constexpr auto operator()(V const& v, R const& r) const -> T {
+    return hvwfg<T>(v, r);
+  }
 
-  // Insert a new solution and return the contribution of that solution
-  // w.r.t. to the indicator value.
-  virtual auto insert(solution_type const& s) -> value_type = 0;
-  virtual auto insert(solution_type&& s) -> value_type = 0;
-};
+  template <is_objective_vector_set S, is_objective_vector R>
+  [[nodiscard]] auto operator()(S const& set, R const& r, bool sorted = false) const -> T {
+    return operator()(set, r, sorted, std::thread::hardware_concurrency());
+  }
 
-template <typename Value, typename ObjectiveVector = std::vector<Value>>
-class [[nodiscard]] incremental_hvwfg : hvwfg_fn<Value> {
- public:
-  using value_type = Value;
-  using objective_vector_type = ObjectiveVector;
+  // Same as above but with a given number of threads (where 0 means
+  // std::thread::hardware_concurrency()).
+  template <is_objective_vector_set S, is_objective_vector R>
+  [[nodiscard]] auto operator()(S const& set, R const& r, bool sorted, size_type threads) const -> T {
+    auto m = std::ranges::size(r);
+    if (m <= 3) {
+      return hvwfg<T>(set, r, sorted);
+    }
+    threads = std::max(threads, size_type{1});
+
+    auto workers = std::vector<worker>(threads);
+    workers[0].workspace.load(set, r, sorted);
+    auto const& top = workers[0].workspace.m_levels[m];
+    auto const* first = workers[0].workspace.m_data.data() + top.set;
+    auto root = wfg_node(m, T{1}, std::vector<T>(first, first + top.set_size * m));
+    auto n = root.excl.size();
+    for (auto& w : workers) {
+      w.workspace.reserve(n, m);
+      w.workspace.load_reference(r);
+    }
 
-  template <typename... ReferenceArgs>
-  constexpr explicit incremental_hvwfg(ReferenceArgs&&... reference_args)
-      : m_value(0)
-      , m_reference(std::forward<ReferenceArgs>(reference_args)...)
-      , m_solution_set() {}
+    auto pending = std::atomic<size_type>(n);
+    for (size_type i = 0; i < n; ++i) {
+      workers[i % threads].tasks.push_back(task{&root, i});
+    }
 
-  constexpr incremental_hvwfg(incremental_hvwfg const& other) = default;
-  constexpr incremental_hvwfg(incremental_hvwfg&& other) = default;
-  constexpr incremental_hvwfg& operator=(incremental_hvwfg const& other) = default;
-  constexpr incremental_hvwfg& operator=(incremental_hvwfg&& other) = default;
-  constexpr ~incremental_hvwfg() = default;
+    auto run = [&workers, &pending](size_type w) {
+      auto& self = workers[w];
+      while (pending.load() > 0) {
+        auto t = pop(self);
+        for (size_type k = 1; !t && k < workers.size(); ++k) {
+          t = steal(workers[(w + k) % workers.size()]);
+        }
+        if (t) {
+          execute(*t, self, pending);
+          pending.fetch_sub(1);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    };
 
-  [[nodiscard]] constexpr auto value() const -> value_type {
-    return m_value;
+    auto pool = std::vector<std::thread>();
+    pool.reserve(threads - 1);
+    for (size_type w = 1; w < threads; ++w) {
+      pool.emplace_back(run, w);
+    }
+    run(0);
+    for (auto& t : pool) {
+      t.join();
+    }
+
+    return reduce(root);
   }
 
-  template <typename S>
-  [[nodiscard]] constexpr auto contribution(S const& s) const -> value_type {
-    if (!mooutils::strictly_dominates(s, m_reference)) {
-      return 0;
-    } else {
-      return this->exclhv(m_solution_set, s, m_reference, 1);
+ private:
+  struct wfg_node;
+
+  // Exclusive hypervolume of a point multiplied by c, which is either
+  // `c * box - value` or `c * box - reduce(*child)` if the subproblem
+  // was split.
+  struct excl_node {
+    T c = T{0};
+    T box = T{0};
+    T value = T{0};
+    std::unique_ptr<wfg_node> child;
+  };
+
+  // Hypervolume of a set of sorted non-dominated points (with d
+  // objectives) multiplied by c, given by the sum of the exclusive
+  // hypervolume of each point.
+  struct wfg_node {
+    wfg_node(size_type dim, T mult, std::vector<T>&& points)
+        : d(dim)
+        , c(mult)
+        , rows(std::move(points))
+        , excl(rows.size() / dim) {}
+
+    size_type d;
+    T c;
+    std::vector<T> rows;
+    std::vector<excl_node> excl;
+  };
+
+  struct task {
+    wfg_node* node;
+    size_type i;
+  };
+
+  struct worker {
+    std::mutex mutex;
+    std::deque<task> tasks;
+    hvwfg_workspace<T> workspace;
+  };
+
+  // The owner takes tasks from the back of its queue, while other
+  // workers steal from the front (the oldest, and usually largest,
+  // tasks).
+  static auto pop(worker& w) -> std::optional<task> {
+    auto lock = std::lock_guard(w.mutex);
+    if (w.tasks.empty()) {
+      return std::nullopt;
     }
+    auto t = w.tasks.back();
+    w.tasks.pop_back();
+    return t;
   }
 
-  template <typename S>
-  constexpr auto insert(S&& s) -> value_type {
-    auto c = contribution(s);
-    if (c > 0) {
-      m_solution_set.insert(std::forward<S>(mooutils::objective_vector(s)));
-      m_value += c;
+  static auto steal(worker& w) -> std::optional<task> {
+    auto lock = std::lock_guard(w.mutex);
+    if (w.tasks.empty()) {
+      return std::nullopt;
     }
-    return c;
+    auto t = w.tasks.front();
+    w.tasks.pop_front();
+    return t;
   }
 
- private:
-  value_type m_value;
-  objective_vector_type m_reference;
-  unordered_minimal_set<objective_vector_type> m_solution_set;
+  static auto execute(task t, worker& self, std::atomic<size_type>& pending) -> void {
+    auto& node = *t.node;
+    auto& ws = self.workspace;
+    auto d = node.d;
+    auto p = node.rows.data() + t.i * d;
+    auto& e = node.excl[t.i];
+
+    e.c = node.c * (p[0] - ws.reference(d)[0]);
+    e.box = ws.box(p + 1, d - 1);
+    ws.limit_prefix(node.rows.data(), t.i, d);
+
+    auto const& lv = ws.m_levels[d - 1];
+    if (d - 1 >= 4 && lv.set_size >= split_size) {
+      auto const* first = ws.m_data.data() + lv.set;
+      e.child = std::make_unique<wfg_node>(d - 1, e.c, std::vector<T>(first, first + lv.set_size * (d - 1)));
+      auto k = e.child->excl.size();
+      pending.fetch_add(k);
+      auto lock = std::lock_guard(self.mutex);
+      for (size_type i = 0; i < k; ++i) {
+        self.tasks.push_back(task{e.child.get(), i});
+      }
+    } else {
+      e.value = ws.wfg(d - 1, e.c);
+    }
+  }
+
+  [[nodiscard]] static auto reduce(wfg_node const& node) -> T {
+    auto v = T{0};
+    for (auto const& e : node.excl) {
+      v += e.c * e.box - (e.child ? reduce(*e.child) : e.value);
+    }
+    return v;
+  }
 };
 
-template <typename Value>
+template <typename T>
+inline constexpr hvwfg_parallel_fn<T> hvwfg_parallel;
+
+template <typename T>
+struct hv_fn {
+  template <is_or_has_objective_vector V, is_objective_vector R>
+  [[nodiscard]] constexpr auto operator()(V const& v, R const& r) const -> T {
+    auto const& ov = objective_vector(v);
+    assert(mooutils::weakly_dominates(ov, r));
+    assert(ov.size() > 1);
+    assert(r.size() == ov.size());
+    return std::transform_reduce(ov.begin(), ov.end(), r.begin(), T{1}, std::multiplies<T>{}, std::minus<T>{});
+  }
+
+  // The algorithm is selected at compile time when the size of the
+  // reference point is static (see static_extent).
+  template <is_objective_vector_set S, is_objective_vector R>
+  [[nodiscard]] constexpr auto operator()(S const& set, R const& r, bool sorted = false) const -> T {
+    constexpr auto m = static_extent_v<R>;
+    if constexpr (m == 2) {
+      return hv2d<T>(set, r, sorted);
+    } else if constexpr (m == 3) {
+      return hv3d<T>(set, r, sorted);
+    } else if constexpr (m == 4) {
+      return hv4d<T>(set, r, sorted);
+    } else if constexpr (m != std::dynamic_extent) {
+      return hvwfg<T>(set, r, sorted);
+    } else if (r.size() == 2) {
+      return hv2d<T>(set, r, sorted);
+    } else if (r.size() == 3) {
+      return hv3d<T>(set, r, sorted);
+    } else if (r.size() == 4) {
+      return hv4d<T>(set, r, sorted);
+    } else {
+      return hvwfg<T>(set, r, sorted);
+    }
+  }
+};
+
+template <typename T>
+inline constexpr hv_fn<T> hv;
+
+// Exclusive hypervolume contributions of every point in a set, in the
+// same order as the points in the set. The contribution of a point is
+// the hypervolume lost by removing it from the set, so dominated points
+// contribute nothing but may reduce the contribution of the (single)
+// point dominating them, and duplicated points contribute nothing.
+
+// Sweeps the points in decreasing order of the first objective, keeping
+// the largest and second largest values of the second objective, such
+// that the slab between two consecutive points is exclusive to the
+// owner of the largest value. Runs in O(n log n) time.
+template <typename T>
+struct hv_contributions2d_fn {
+  template <is_objective_vector_set S, is_objective_vector R>
+  [[nodiscard]] constexpr auto operator()(S const& set, R const& r) const -> std::vector<T> {
+    using ov_type = std::array<T, 2>;
+    auto points = std::vector<ov_type>();
+    points.reserve(set.size());
+    for (auto const& v : objective_vectors(set)) {
+      points.push_back(ov_type{v[0], v[1]});
+    }
+
+    auto order = std::vector<size_t>(points.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::ranges::sort(order, [&points](auto i, auto j) { return points[i][0] > points[j][0]; });
+
+    constexpr auto none = std::numeric_limits<size_t>::max();
+    auto res = std::vector<T>(points.size(), T{0});
+    auto owner = none;
+    auto first = T{r[1]};
+    auto second = T{r[1]};
+    auto x = T{r[0]};
+    for (auto i : order) {
+      auto const& p = points[i];
+      if (owner != none) {
+        res[owner] += (x - p[0]) * (first - second);
+      }
+      x = p[0];
+      if (p[1] > first) {
+        second = first;
+        first = p[1];
+        owner = i;
+      } else if (p[1] > second) {
+        second = p[1];
+      }
+    }
+    if (owner != none) {
+      res[owner] += (x - r[0]) * (first - second);
+    }
+    return res;
+  }
+};
+
+template <typename T>
+inline constexpr hv_contributions2d_fn<T> hv_contributions2d;
+
+// Sweeps the points in decreasing order of the last objective, keeping
+// the region exclusively dominated by each point on the first two
+// objectives as a set of columns along the first objective. Each column
+// stores the largest and second largest values of the second objective
+// over the points swept so far, the owner of the largest value, and the
+// value of the last objective when the column was last updated. A new
+// point updates the columns to its left whose second largest value is
+// smaller than its own, crediting their volume so far to their owners,
+// and merges the updated columns that end up with the same state. Since
+// each point creates O(1) columns in amortized terms, this runs in
+// O(n log n) time, similar to the HVC3D algorithm of "M. T. M. Emmerich
+// and C. M. Fonseca, "Computing Hypervolume Contributions in Low
+// Dimensions: Asymptotically Optimal Algorithm and Complexity Results,"
+// in Evolutionary Multi-Criterion Optimization, pp. 121-135, 2011."
+template <typename T>
+struct hv_contributions3d_fn {
+  template <is_objective_vector_set S, is_objective_vector R>
+  [[nodiscard]] auto operator()(S const& set, R const& r) const -> std::vector<T> {
+    using ov_type = std::array<T, 3>;
+    auto points = std::vector<ov_type>();
+    points.reserve(set.size());
+    for (auto const& v : objective_vectors(set)) {
+      points.push_back(ov_type{v[0], v[1], v[2]});
+    }
+
+    auto order = std::vector<size_t>(points.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::ranges::sort(order, [&points](auto i, auto j) { return points[i][2] > points[j][2]; });
+
+    constexpr auto none = std::numeric_limits<size_t>::max();
+    struct column {
+      T first;
+      T second;
+      size_t owner;
+      T z;
+
+      [[nodiscard]] constexpr auto same_state(column const& other) const -> bool {
+        return first == other.first && second == other.second && owner == other.owner;
+      }
+    };
+
+    // Columns are keyed by their left end, and end where the next one
+    // starts. The nodes are allocated from a monotonic buffer, since
+    // only O(n) columns are ever created.
+    auto resource = std::pmr::monotonic_buffer_resource();
+    auto columns = std::pmr::map<T, column>(&resource);
+    columns.emplace(T{r[0]}, column{T{r[1]}, T{r[1]}, none, T{r[2]}});
+
+    auto res = std::vector<T>(points.size(), T{0});
+    auto close = [&res](auto it, T z) {
+      auto const& c = it->second;
+      if (c.owner != none) {
+        res[c.owner] += (std::next(it)->first - it->first) * (c.first - c.second) * (c.z - z);
+      }
+    };
+
+    for (auto i : order) {
+      auto const& p = points[i];
+
+      // Column containing p[0], if it is affected by p
+      auto it = columns.lower_bound(p[0]);
+      if (it == columns.begin()) {
+        continue;
+      }
+      --it;
+      if (it->second.second >= p[1]) {
+        continue;
+      }
+
+      // Split it at p[0], the right part is not affected
+      auto jt = std::next(it);
+      if (jt == columns.end() || jt->first != p[0]) {
+        columns.emplace_hint(jt, p[0], it->second);
+      }
+
+      // Update the columns to the left while they are affected
+      auto right = columns.end();
+      while (true) {
+        close(it, p[2]);
+        auto& c = it->second;
+        if (c.first < p[1]) {
+          c = column{p[1], c.first, i, p[2]};
+        } else {
+          c = column{c.first, p[1], c.owner, p[2]};
+        }
+        if (right != columns.end() && c.same_state(right->second)) {
+          columns.erase(right);
+        }
+        if (it == columns.begin() || std::prev(it)->second.second >= p[1]) {
+          break;
+        }
+        right = it--;
+      }
+    }
+
+    for (auto it = columns.begin(); it != columns.end(); ++it) {
+      close(it, T{r[2]});
+    }
+    return res;
+  }
+};
+
+template <typename T>
+inline constexpr hv_contributions3d_fn<T> hv_contributions3d;
+
+// Dispatches to hv_contributions2d and hv_contributions3d, and for more
+// objectives computes the exclusive contribution of each point with
+// the WFG algorithm, reusing a single workspace.
+template <typename T>
+struct hv_contributions_fn {
+  template <is_objective_vector_set S, is_objective_vector R>
+  [[nodiscard]] constexpr auto operator()(S const& set, R const& r) const -> std::vector<T> {
+    constexpr auto m = static_extent_v<R>;
+    if constexpr (m == 2) {
+      return hv_contributions2d<T>(set, r);
+    } else if constexpr (m == 3) {
+      return hv_contributions3d<T>(set, r);
+    } else if constexpr (m != std::dynamic_extent) {
+      auto workspace = hvwfg_workspace<T>();
+      return workspace.contributions(set, r);
+    } else if (r.size() == 2) {
+      return hv_contributions2d<T>(set, r);
+    } else if (r.size() == 3) {
+      return hv_contributions3d<T>(set, r);
+    } else {
+      auto workspace = hvwfg_workspace<T>();
+      return workspace.contributions(set, r);
+    }
+  }
+};
+
+template <typename T>
+inline constexpr hv_contributions_fn<T> hv_contributions;
+
+// Pure virtual class for quality indicator structures that allow for
+// incrementally updating a quality indicator with respect to the
+// insertion of new solutions into the set.
+//
+// TODO allow initializing with a set of existing solutions (and
+// optionally their hypervolume).
+template <typename Value, typename Solution>
+class increment_indicator {
+ public:
+  using value_type = Value;
+  using solution_type = Solution;
+
+  // Get the current indicator value.
+  virtual auto value() const -> value_type = 0;
+
+  // Find the contribution of a solution.
+  virtual auto contribution(solution_type const& s) const -> value_type = 0;
+
+  // Insert a new solution and return the contribution of that solution
+  // w.r.t. to the indicator value.
+  virtual auto insert(solution_type const& s) -> value_type = 0;
+  virtual auto insert(solution_type&& s) -> value_type = 0;
+};
+
+template <typename Value, typename ObjectiveVector = std::vector<Value>>
+class [[nodiscard]] incremental_hvwfg {
+ public:
+  using value_type = Value;
+  using objective_vector_type = ObjectiveVector;
+
+  template <typename... ReferenceArgs>
+  constexpr explicit incremental_hvwfg(ReferenceArgs&&... reference_args)
+      : m_value(0)
+      , m_reference(std::forward<ReferenceArgs>(reference_args)...)
+      , m_solution_set() {}
+
+  constexpr incremental_hvwfg(incremental_hvwfg const& other) = default;
+  constexpr incremental_hvwfg(incremental_hvwfg&& other) = default;
+  constexpr incremental_hvwfg& operator=(incremental_hvwfg const& other) = default;
+  constexpr incremental_hvwfg& operator=(incremental_hvwfg&& other) = default;
+  constexpr ~incremental_hvwfg() = default;
+
+  [[nodiscard]] constexpr auto value() const -> value_type {
+    return m_value;
+  }
+
+  // Uses the workspace of the structure, which is shared with insert and
+  // erase, so it must not be called from several threads at once (as for
+  // the other incremental structures). Threads querying the same
+  // structure can give their own workspace to the overload below.
+  template <typename S>
+  [[nodiscard]] constexpr auto contribution(S const& s) const -> value_type {
+    return contribution(s, m_workspace);
+  }
+
+  template <typename S>
+  [[nodiscard]] constexpr auto contribution(S const& s, hvwfg_workspace<value_type>& workspace) const
+      -> value_type {
+    if (!mooutils::strictly_dominates(s, m_reference)) {
+      return 0;
+    } else {
+      return workspace.exclhv(m_solution_set, s, m_reference);
+    }
+  }
+
+  template <typename S>
+  constexpr auto insert(S&& s) -> value_type {
+    auto c = contribution(s, m_workspace);
+    if (c > 0) {
+      m_solution_set.insert(std::forward<S>(mooutils::objective_vector(s)));
+      m_value += c;
+    }
+    return c;
+  }
+
+  // Remove the point with the same objective vector as s, if any, and
+  // return its contribution, which is subtracted from the value.
+  template <typename S>
+  constexpr auto erase(S const& s) -> value_type {
+    auto const& ov = mooutils::objective_vector(s);
+    auto it = std::ranges::find_if(m_solution_set, [&ov](auto const& v) { return std::ranges::equal(v, ov); });
+    if (it == m_solution_set.end()) {
+      return 0;
+    }
+
+    m_solution_set.erase(it);
+    auto c = contribution(s, m_workspace);
+    m_value -= c;
+    return c;
+  }
+
+  // Same as erase(s), but then inserts the points in `candidates`, such
+  // as the points that were removed for being dominated by s. Returns
+  // the decrease in value.
+  template <typename S, std::ranges::input_range C>
+  constexpr auto erase(S const& s, C const& candidates) -> value_type {
+    auto c = erase(s);
+    for (auto const& v : candidates) {
+      c -= insert(v);
+    }
+    return c;
+  }
+
+ private:
+  value_type m_value;
+  objective_vector_type m_reference;
+  unordered_minimal_set<objective_vector_type> m_solution_set;
+  // Scratch space for computing contributions, which grows with the set
+  // and is reused across calls.
+  mutable hvwfg_workspace<value_type> m_workspace;
+};
+
+template <typename Value>
 class [[nodiscard]] incremental_hv2d {
   struct Cmp {
     template <typename Lhs, typename Rhs>
@@ -345,6 +1212,11 @@ class [[nodiscard]] incremental_hv2d {
     if ((*it)[1] >= s[1]) {
       return 0;
     }
+    // A point with the same [0] is dominated by s, so we start from the
+    // one before it (the first point always has a larger [0])
+    if ((*it)[0] == ov[0]) {
+      --it;
+    }
 
     auto s0 = value_type{ov[0]};
     auto s1 = value_type{ov[1]};
@@ -372,6 +1244,11 @@ class [[nodiscard]] incremental_hv2d {
     if ((*it)[1] >= s[1]) {
       return 0;
     }
+    // A point with the same [0] is dominated by s, so we start from the
+    // one before it (the first point always has a larger [0])
+    if ((*it)[0] == ov[0]) {
+      --it;
+    }
 
     auto first_erase = std::next(it);
 
@@ -398,6 +1275,35 @@ class [[nodiscard]] incremental_hv2d {
     return res;
   }
 
+  // Remove the point with the same objective vector as s, if any, and
+  // return its contribution, which is subtracted from the value.
+  template <typename S>
+  constexpr auto erase(S const& s) -> value_type {
+    auto const& ov = mooutils::objective_vector(s);
+    auto it = std::ranges::lower_bound(m_solution_set, ov, Cmp{});
+    if (it == m_solution_set.begin() || std::next(it) >= m_solution_set.end() || (*it)[0] != ov[0] ||
+        (*it)[1] != ov[1]) {
+      return 0;
+    }
+
+    auto res = (value_type{ov[0]} - (*std::next(it))[0]) * (value_type{ov[1]} - (*std::prev(it))[1]);
+    m_solution_set.erase(it);
+    m_value -= res;
+    return res;
+  }
+
+  // Same as erase(s), but then inserts the points in `candidates`, such
+  // as the points that were removed for being dominated by s. Returns
+  // the decrease in value.
+  template <typename S, std::ranges::input_range C>
+  constexpr auto erase(S const& s, C const& candidates) -> value_type {
+    auto res = erase(s);
+    for (auto const& c : candidates) {
+      res -= insert(c);
+    }
+    return res;
+  }
+
   value_type m_value;
   objective_vector_type m_reference;
   std::vector<objective_vector_type> m_solution_set;
@@ -408,93 +1314,124 @@ class [[nodiscard]] incremental_hv2d {
 // Dimensions," in IEEE Transactions on Evolutionary Computation, vol.
 // 22, no. 3, pp. 449-463, June 2018, doi: 10.1109/TEVC.2017.2729550."
 //
-// TODO Recheck the paper and implementation to see if it can be
-// improved.
+// The points are kept in a pool of nodes linked by 32-bit offsets
+// instead of pointers. Removed nodes are recycled through a free list,
+// so that a long sequence of insertions does not allocate once the
+// pool has grown, and the container can be copied as is.
 //
-// TODO Clean up this class a bit and make it safer. Not urgent, since
-// several passes with valgrind on different data sets revealed no
-// leaks, so the implementation seems to be sound.
+// Inserting a point visits the points above it once, to check
+// dominance and find its delimiters and position, and the points below
+// it once, to remove the dominated ones and update their delimiters.
+// The dominance check and the delimiters are queries over the points
+// above the new point in z and inside a quadrant in (x, y), so an index
+// ordered on (x, y) alone can not answer them, and the scan is kept.
 //
-// TODO Allow for a custom allocator
+// TODO Recheck the paper and implementation to see if it can be
+// improved.
 //
 // TODO Keep actual solutions instead of only the objective points (to
 // be consistent with other indicator sets).
-template <typename Value>
+template <typename Value, typename Allocator>
 class [[nodiscard]] incremental_hv3dplus {
  public:
   using value_type = Value;
   using objective_vector_type = std::array<value_type, 3>;
+  using allocator_type = Allocator;
 
  private:
+  using index_type = uint32_t;
+  static constexpr index_type npos = std::numeric_limits<index_type>::max();
+
+  // The first two nodes of the pool are the sentinels, which are always
+  // the first two nodes in the list. The lprev and lnext links are only
+  // used as scratch space while computing a contribution.
   struct Point {
-    Point(value_type _x, value_type _y, value_type _z)
+    constexpr Point(value_type _x, value_type _y, value_type _z)
         : x(_x)
         , y(_y)
         , z(_z)
-        , prev(NULL)
-        , next(NULL)
-        , cprev(NULL)
-        , cnext(NULL)
-        , lprev(NULL)
-        , lnext(NULL) {}
+        , prev(npos)
+        , next(npos)
+        , cprev(npos)
+        , cnext(npos)
+        , lprev(npos)
+        , lnext(npos) {}
 
     value_type x;
     value_type y;
     value_type z;
-    Point* prev;
-    Point* next;
-    Point* cprev;
-    Point* cnext;
-    Point* lprev;
-    Point* lnext;
+    index_type prev;
+    index_type next;
+    index_type cprev;
+    index_type cnext;
+    mutable index_type lprev;
+    mutable index_type lnext;
+  };
+
+  using point_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Point>;
+
+  // Links are byte offsets into the pool rather than element indices,
+  // such that following a link is a single load without scaling the
+  // index, which matters since most of the time is spent traversing
+  // the lists.
+  template <typename P>
+  struct pool_view {
+    using byte_type = std::conditional_t<std::is_const_v<P>, char const, char>;
+
+    [[nodiscard]] auto operator[](index_type i) const -> P& {
+      return *reinterpret_cast<P*>(reinterpret_cast<byte_type*>(base) + i);
+    }
+
+    P* base;
   };
 
+  static constexpr index_type first = 0;
+  static constexpr index_type second = sizeof(Point);
+
  public:
+  // The reference arguments are constrained so that this constructor
+  // is not picked for copies or for the allocator-extended constructor.
   template <typename... ReferenceArgs>
+    requires((!std::is_same_v<std::remove_cvref_t<ReferenceArgs>, incremental_hv3dplus> &&
+              !std::is_same_v<std::remove_cvref_t<ReferenceArgs>, std::allocator_arg_t>) &&
+             ...)
   constexpr explicit incremental_hv3dplus(ReferenceArgs&&... reference_args)
+      : incremental_hv3dplus(std::allocator_arg, Allocator(), std::forward<ReferenceArgs>(reference_args)...) {}
+
+  template <typename... ReferenceArgs>
+  constexpr incremental_hv3dplus(std::allocator_arg_t, Allocator const& alloc, ReferenceArgs&&... reference_args)
       : m_value{0}
-      , m_reference{std::forward<ReferenceArgs>(reference_args)...} {
-    auto a = new Point(m_reference[0], std::numeric_limits<value_type>::max(), std::numeric_limits<value_type>::max());
-    auto b = new Point(std::numeric_limits<value_type>::max(), m_reference[1], std::numeric_limits<value_type>::max());
-    a->next = b;
-    b->prev = a;
-    b->cprev = a;
-    m_solution_set = a;
+      , m_reference{std::forward<ReferenceArgs>(reference_args)...}
+      , m_points(point_allocator_type(alloc))
+      , m_free(npos) {
+    m_points.emplace_back(0, 0, 0);
+    m_points.emplace_back(0, 0, 0);
+    reset_sentinels();
   }
 
-  // TODO Copy constructor is not trivial to implement, but also not
-  // very important at the moment. I think there is the need to track
-  // old and new pointers, to correctly copy all of prev, next, cprev,
-  // cnext, lprev, lnext.
-  constexpr incremental_hv3dplus(incremental_hv3dplus const& other) = delete;
-  constexpr incremental_hv3dplus& operator=(incremental_hv3dplus const& other) = delete;
+  constexpr incremental_hv3dplus(incremental_hv3dplus const& other) = default;
+  constexpr incremental_hv3dplus(incremental_hv3dplus&& other) noexcept = default;
+  constexpr incremental_hv3dplus& operator=(incremental_hv3dplus const& other) = default;
+  constexpr incremental_hv3dplus& operator=(incremental_hv3dplus&& other) noexcept = default;
+  constexpr ~incremental_hv3dplus() = default;
 
-  constexpr incremental_hv3dplus(incremental_hv3dplus&& other) noexcept
-      : m_value(std::move(other.m_value))
-      , m_reference(std::move(other.m_reference))
-      , m_solution_set(other.m_solution_set) {
-    other.m_solution_set = NULL;
+  [[nodiscard]] constexpr auto get_allocator() const -> allocator_type {
+    return allocator_type(m_points.get_allocator());
   }
 
-  constexpr incremental_hv3dplus& operator=(incremental_hv3dplus&& other) noexcept {
-    while (m_solution_set != NULL) {
-      auto n = m_solution_set->next;
-      delete m_solution_set;
-      m_solution_set = n;
-    }
-    m_value = std::move(other.m_value);
-    m_reference = std::move(other.m_reference);
-    m_solution_set = std::move(other.m_solution_set);
-    other.m_solution_set = NULL;
-    return *this;
+  // Reserve space for n points, such that no allocation happens until
+  // the container holds more than n points.
+  constexpr auto reserve(size_t n) -> void {
+    m_points.reserve(n + 2);
   }
 
-  constexpr ~incremental_hv3dplus() {
-    while (m_solution_set != NULL) {
-      auto n = m_solution_set->next;
-      delete m_solution_set;
-      m_solution_set = n;
-    }
+  // Removes all the points, keeping the reference point and the nodes
+  // allocated so far.
+  constexpr auto clear() -> void {
+    m_value = 0;
+    m_points.erase(m_points.begin() + 2, m_points.end());
+    m_free = npos;
+    reset_sentinels();
   }
 
   // Get the current hypervolume value
@@ -504,207 +1441,469 @@ class [[nodiscard]] incremental_hv3dplus {
 
   template <typename S>
   [[nodiscard]] constexpr auto contribution(S const& s) const -> value_type {
-    auto const& u = mooutils::objective_vector(s);
+    if (!mooutils::strictly_dominates(s, m_reference)) {
+      return 0;
+    }
+    return contribution(mooutils::objective_vector(s), static_cast<location*>(nullptr));
+  }
 
-    // Check if u is dominated by any point in q
-    for (auto it = m_solution_set; it != NULL && it->z >= u[2]; it = it->next) {
-      if (it->x >= u[0] && it->y >= u[1]) {
-        return 0;
+  template <typename S>
+  constexpr auto insert(S&& s) -> value_type {
+    if (!mooutils::strictly_dominates(s, m_reference)) {
+      return 0;
+    }
+
+    auto const& p = mooutils::objective_vector(s);
+    auto loc = location{second, first, second};
+    auto hvc = contribution(p, &loc);
+    if (hvc == 0) {
+      return 0;
+    }
+    m_value += hvc;
+
+    auto u = allocate(p[0], p[1], p[2]);
+    auto q = pool_view<Point>{m_points.data()};
+
+    // Remove non-dominated points in q
+    auto custom_weakly_dominates = [q](index_type a, index_type b) {
+      return q[a].x >= q[b].x && q[a].y >= q[b].y && q[a].z >= q[b].z;
+    };
+
+    // The points above u were visited by contribution, which gave the
+    // delimiters of u and the position to link it. u is a candidate for
+    // the delimiters of the points below it, some of which may be
+    // dominated by u.
+    q[u].cprev = loc.cprev;
+    q[u].cnext = loc.cnext;
+    auto prev = loc.prev;
+    auto it = q[prev].next;
+
+    q[u].prev = prev;
+    q[u].next = it;
+    q[prev].next = u;
+    if (it != npos) {
+      q[it].prev = u;
+    }
+
+    while (it != npos) {
+      auto next = q[it].next;
+      if (custom_weakly_dominates(u, it)) {
+        q[q[it].prev].next = next;
+        if (next != npos) {
+          q[next].prev = q[it].prev;
+        }
+        deallocate(it);
+      } else {
+        try_update_cnext(q, it, u);
+        try_update_cprev(q, it, u);
+      }
+      it = next;
+    }
+
+    return hvc;
+  }
+
+  // Remove the point with the same objective vector as s, if any, and
+  // return its contribution, which is subtracted from the value. The
+  // points that had it as a delimiter get new delimiters, each found by
+  // scanning the points above them.
+  template <typename S>
+  constexpr auto erase(S const& s) -> value_type {
+    auto const& p = mooutils::objective_vector(s);
+    auto q = pool_view<Point>{m_points.data()};
+
+    auto u = q[second].next;
+    for (; u != npos && q[u].z >= p[2]; u = q[u].next) {
+      if (q[u].x == p[0] && q[u].y == p[1] && q[u].z == p[2]) {
+        break;
+      }
+    }
+    if (u == npos || q[u].z < p[2]) {
+      return 0;
+    }
+
+    q[q[u].prev].next = q[u].next;
+    if (q[u].next != npos) {
+      q[q[u].next].prev = q[u].prev;
+    }
+
+    for (auto w = q[u].next; w != npos; w = q[w].next) {
+      if (q[w].cprev == u || q[w].cnext == u) {
+        q[w].cprev = npos;
+        q[w].cnext = npos;
+        for (auto it = first; it != w; it = q[it].next) {
+          try_update_cnext(q, w, it);
+          try_update_cprev(q, w, it);
+        }
       }
     }
+    deallocate(u);
+
+    auto hvc = contribution(s);
+    m_value -= hvc;
+    return hvc;
+  }
+
+  // Same as erase(s), but then inserts the points in `candidates`, such
+  // as the points that were removed for being dominated by s. Returns
+  // the decrease in value.
+  template <typename S, std::ranges::input_range C>
+  constexpr auto erase(S const& s, C const& candidates) -> value_type {
+    auto hvc = erase(s);
+    for (auto const& c : candidates) {
+      hvc -= insert(c);
+    }
+    return hvc;
+  }
+
+ private:
+  // Where a point is linked when it is inserted: after the last point
+  // that is lexicographically greater or equal (prev), and its
+  // delimiters among those points.
+  struct location {
+    index_type prev;
+    index_type cprev;
+    index_type cnext;
+  };
+
+  // Contribution of u, which also finds its location if loc is given.
+  template <typename V>
+  [[nodiscard]] constexpr auto contribution(V const& u, location* loc) const -> value_type {
+    auto q = pool_view<Point const>{m_points.data()};
+
+    // Check if u is dominated by the sentinels, the remaining points
+    // are checked while finding the outer delimiters
+    if (q[first].x >= u[0] || q[second].y >= u[1]) {
+      return 0;
+    }
 
     // Utilities functions (TODO maybe move them to class functions?)
-    auto compute_area_from_prev = [](value_type x, value_type y, Point* cprev) {
+    auto compute_area_from_prev = [q](value_type x, value_type y, index_type cprev) {
       value_type a = 0;
-      auto rx = cprev->x;
+      auto rx = q[cprev].x;
       auto ry = y;
-      auto it = cprev->lnext;
-      for (; it->x <= x; it = it->lnext) {
-        a += (x - rx) * (ry - it->y);
-        rx = it->x;
-        ry = it->y;
+      auto it = q[cprev].lnext;
+      for (; q[it].x <= x; it = q[it].lnext) {
+        a += (x - rx) * (ry - q[it].y);
+        rx = q[it].x;
+        ry = q[it].y;
       }
-      a += (x - rx) * (ry - it->y);
+      a += (x - rx) * (ry - q[it].y);
       return a;
     };
 
-    auto compute_area_from_next = [](value_type x, value_type y, Point* cnext) {
+    auto compute_area_from_next = [q](value_type x, value_type y, index_type cnext) {
       value_type a = 0;
       auto rx = x;
-      auto ry = cnext->y;
-      auto it = cnext->lprev;
-      for (; it->y <= y; it = it->lprev) {
-        a += (rx - it->x) * (y - ry);
-        rx = it->x;
-        ry = it->y;
-      }
-      a += (rx - it->x) * (y - ry);
+      auto ry = q[cnext].y;
+      auto it = q[cnext].lprev;
+      for (; q[it].y <= y; it = q[it].lprev) {
+        a += (rx - q[it].x) * (y - ry);
+        rx = q[it].x;
+        ry = q[it].y;
+      }
+      a += (rx - q[it].x) * (y - ry);
       return a;
     };
 
-    // Find outer delimeters
-    Point* cprev = m_solution_set;
-    Point* cnext = m_solution_set->next;
+    // Find outer delimeters, and check if u is dominated by any point
+    // above it
+    index_type cprev = first;
+    index_type cnext = second;
 
-    cprev->lprev = NULL;
-    cprev->lnext = cnext;
-    cnext->lprev = cprev;
-    cnext->lnext = NULL;
+    q[cprev].lprev = npos;
+    q[cprev].lnext = cnext;
+    q[cnext].lprev = cprev;
+    q[cnext].lnext = npos;
 
-    auto p = m_solution_set->next->next;
-    for (; p != NULL && p->z >= u[2]; p = p->next) {
-      if (p->x < u[0] && p->y > u[1]) {
-        if (p->x > cprev->x || (p->x == cprev->x && p->y > cprev->y)) {
+    auto p = q[second].next;
+    for (; p != npos && q[p].z >= u[2]; p = q[p].next) {
+      if (q[p].x >= u[0] && q[p].y >= u[1]) {
+        return 0;
+      }
+
+      // The delimiters of u once inserted are taken among the points
+      // lexicographically greater or equal, and with ties resolved
+      // towards the last one, as in try_update_cprev/try_update_cnext.
+      if (loc != nullptr && (q[p].z > u[2] || q[p].y > u[1] || (q[p].y == u[1] && q[p].x >= u[0]))) {
+        loc->prev = p;
+        auto lp = loc->cprev;
+        if (q[p].x < u[0] && q[p].y > u[1] && (q[p].x > q[lp].x || (q[p].x == q[lp].x && q[p].y >= q[lp].y))) {
+          loc->cprev = p;
+        }
+        auto ln = loc->cnext;
+        if (q[p].x > u[0] && q[p].y < u[1] && (q[p].y > q[ln].y || (q[p].y == q[ln].y && q[p].x >= q[ln].x))) {
+          loc->cnext = p;
+        }
+      }
+
+      if (q[p].x < u[0] && q[p].y > u[1]) {
+        if (q[p].x > q[cprev].x || (q[p].x == q[cprev].x && q[p].y > q[cprev].y)) {
           cprev = p;
         }
       }
 
-      if (p->x > u[0] && p->y < u[1]) {
-        if (p->y > cnext->y || (p->y == cnext->y && p->x > cnext->x)) {
+      if (q[p].x > u[0] && q[p].y < u[1]) {
+        if (q[p].y > q[cnext].y || (q[p].y == q[cnext].y && q[p].x > q[cnext].x)) {
           cnext = p;
         }
       }
 
-      auto sp = p->cprev;
-      auto sn = p->cnext;
-      sp->lnext = p;
-      sn->lprev = p;
-      p->lprev = sp;
-      p->lnext = sn;
+      auto sp = q[p].cprev;
+      auto sn = q[p].cnext;
+      q[sp].lnext = p;
+      q[sn].lprev = p;
+      q[p].lprev = sp;
+      q[p].lnext = sn;
     }
 
     // Find area contribution
     auto a = compute_area_from_prev(u[0], u[1], cprev);
     auto v = value_type{0};
     auto z = value_type{u[2]};
-    for (; p != NULL && (p->x < u[0] || p->y < u[1]); p = p->next) {
-      v += a * (z - p->z);
-      z = p->z;
+    for (; p != npos && (q[p].x < u[0] || q[p].y < u[1]); p = q[p].next) {
+      v += a * (z - q[p].z);
+      z = q[p].z;
       auto ac = value_type{0};
-      if (p->y >= u[1] && p->x >= cprev->x) {
-        ac = compute_area_from_next(p->x, u[1], p->cnext);
+      if (q[p].y >= u[1] && q[p].x >= q[cprev].x) {
+        ac = compute_area_from_next(q[p].x, u[1], q[p].cnext);
         cprev = p;
-      } else if (p->x >= u[0] && p->y >= cnext->y) {
-        ac = compute_area_from_prev(u[0], p->y, p->cprev);
+      } else if (q[p].x >= u[0] && q[p].y >= q[cnext].y) {
+        ac = compute_area_from_prev(u[0], q[p].y, q[p].cprev);
         cnext = p;
-      } else if (p->x <= u[0] && p->y <= u[1]) {
-        ac = compute_area_from_prev(p->x, p->y, p->cprev);
+      } else if (q[p].x <= u[0] && q[p].y <= u[1]) {
+        ac = compute_area_from_prev(q[p].x, q[p].y, q[p].cprev);
       } else {
         continue;
       }
       a -= ac;
 
-      auto sp = p->cprev;
-      auto sn = p->cnext;
-      sp->lnext = p;
-      p->lprev = sp;
-      p->lnext = sn;
-      sn->lprev = p;
+      auto sp = q[p].cprev;
+      auto sn = q[p].cnext;
+      q[sp].lnext = p;
+      q[p].lprev = sp;
+      q[p].lnext = sn;
+      q[sn].lprev = p;
     }
 
-    if (p == NULL) {
+    if (p == npos) {
       v += a * (z - m_reference[2]);
     } else {
-      v += a * (z - p->z);
+      v += a * (z - q[p].z);
     }
 
     return v;
   }
 
+ private:
+  constexpr auto reset_sentinels() -> void {
+    m_points[0] = Point(m_reference[0], std::numeric_limits<value_type>::max(), std::numeric_limits<value_type>::max());
+    m_points[1] = Point(std::numeric_limits<value_type>::max(), m_reference[1], std::numeric_limits<value_type>::max());
+    m_points[0].next = second;
+    m_points[1].prev = first;
+    m_points[1].cprev = first;
+  }
+
+  // Updates the delimiters of a with b, which must be above a.
+  static constexpr auto try_update_cprev(pool_view<Point> q, index_type a, index_type b) -> void {
+    if (q[b].x < q[a].x && q[b].y > q[a].y) {
+      if (q[a].cprev == npos) {
+        q[a].cprev = b;
+      } else if (q[b].x > q[q[a].cprev].x || (q[b].x == q[q[a].cprev].x && q[b].y >= q[q[a].cprev].y)) {
+        q[a].cprev = b;
+      }
+    }
+  }
+
+  static constexpr auto try_update_cnext(pool_view<Point> q, index_type a, index_type b) -> void {
+    if (q[b].x > q[a].x && q[b].y < q[a].y) {
+      if (q[a].cnext == npos) {
+        q[a].cnext = b;
+      } else if (q[b].y > q[q[a].cnext].y || (q[b].y == q[q[a].cnext].y && q[b].x >= q[q[a].cnext].x)) {
+        q[a].cnext = b;
+      }
+    }
+  }
+
+  // Takes a node from the free list, or a new one from the pool if the
+  // free list is empty.
+  constexpr auto allocate(value_type x, value_type y, value_type z) -> index_type {
+    auto q = pool_view<Point>{m_points.data()};
+    if (m_free != npos) {
+      auto i = m_free;
+      m_free = q[i].next;
+      q[i] = Point(x, y, z);
+      return i;
+    }
+    if (m_points.size() >= npos / sizeof(Point)) {
+      throw("Too many points in incremental_hv3dplus");
+    }
+    m_points.emplace_back(x, y, z);
+    return static_cast<index_type>((m_points.size() - 1) * sizeof(Point));
+  }
+
+  // Returns a node to the free list.
+  constexpr auto deallocate(index_type i) -> void {
+    pool_view<Point>{m_points.data()}[i].next = m_free;
+    m_free = i;
+  }
+
+  value_type m_value;
+  objective_vector_type m_reference;
+  std::vector<Point, point_allocator_type> m_points;
+  index_type m_free;
+};
+
+// HV4D+ container based on the same paper as incremental_hv3dplus.
+//
+// The points are kept in decreasing lexicographical order, such that
+// the contribution of a point u is computed by sweeping the points in
+// decreasing order of the first objective, while the 3D contribution of
+// the projection of u w.r.t. the points swept so far is kept. Only the
+// part of a point q inside the box of u reduces it, so an HV3D+
+// structure holds the projections of the joint points min(q, u), and
+// the 3D contribution is the volume of the box minus their hypervolume.
+// Since the joint points lie in the box of u, most of them are
+// dominated and rejected early, and the structure stays small, such
+// that a contribution takes O(n k) time, where k is the number of non
+// dominated joint points (at most n). The structure is kept by the
+// container and reused by insert and erase, such that its nodes are
+// only allocated once.
+template <typename Value>
+class [[nodiscard]] incremental_hv4dplus {
+ public:
+  using value_type = Value;
+  using objective_vector_type = std::array<value_type, 4>;
+
+  template <typename... ReferenceArgs>
+  constexpr explicit incremental_hv4dplus(ReferenceArgs&&... reference_args)
+      : m_value{0}
+      , m_reference{std::forward<ReferenceArgs>(reference_args)...}
+      , m_solution_set()
+      , m_joins(m_reference[1], m_reference[2], m_reference[3]) {}
+
+  constexpr incremental_hv4dplus(incremental_hv4dplus&& other) = default;
+  constexpr incremental_hv4dplus(incremental_hv4dplus const& other) = default;
+  constexpr incremental_hv4dplus& operator=(incremental_hv4dplus&& other) = default;
+  constexpr incremental_hv4dplus& operator=(incremental_hv4dplus const& other) = default;
+  constexpr ~incremental_hv4dplus() = default;
+
+  // Get the current hypervolume value
+  [[nodiscard]] constexpr auto value() const -> value_type {
+    return m_value;
+  }
+
+  // Uses the HV3D+ structure of the container, which is shared with
+  // insert and erase, so it must not be called from several threads at
+  // once.
   template <typename S>
-  constexpr auto insert(S&& s) -> value_type {
-    auto hvc = contribution(s);
+  [[nodiscard]] constexpr auto contribution(S const& s) const -> value_type {
+    return contribution(s, m_joins);
+  }
+
+  template <typename S>
+  constexpr auto insert(S const& s) -> value_type {
+    auto hvc = contribution(s, m_joins);
     if (hvc == 0) {
       return 0;
     }
     m_value += hvc;
 
-    auto const& p = mooutils::objective_vector(s);
+    auto const& ov = mooutils::objective_vector(s);
+    auto u = objective_vector_type{ov[0], ov[1], ov[2], ov[3]};
 
-    // Utility functions (TODO maybe move to class private methods)
-    auto try_update_cprev = [](Point* u, Point* v) {
-      if (v->x < u->x && v->y > u->y) {
-        if (u->cprev == NULL) {
-          u->cprev = v;
-        } else if (v->x > u->cprev->x || (v->x == u->cprev->x && v->y >= u->cprev->y)) {
-          u->cprev = v;
-        }
-      }
-    };
+    // Remove the points dominated by u and insert it in order
+    std::erase_if(m_solution_set, [&u](auto const& q) { return mooutils::weakly_dominates(u, q); });
+    auto it = std::ranges::upper_bound(m_solution_set, u, lexicographically_greater_fn{});
+    m_solution_set.insert(it, u);
 
-    auto try_update_cnext = [](Point* u, Point* v) {
-      if (v->x > u->x && v->y < u->y) {
-        if (u->cnext == NULL) {
-          u->cnext = v;
-        } else if (v->y > u->cnext->y || (v->y == u->cnext->y && v->x >= u->cnext->x)) {
-          u->cnext = v;
-        }
-      }
-    };
+    return hvc;
+  }
 
-    // Remove non-dominated points in q
-    auto custom_weakly_dominates = [](Point* a, Point* b) {
-      return a->x >= b->x && a->y >= b->y && a->z >= b->z;
-    };
+  // Remove the point with the same objective vector as s, if any, and
+  // return its contribution, which is subtracted from the value.
+  template <typename S>
+  constexpr auto erase(S const& s) -> value_type {
+    auto const& ov = mooutils::objective_vector(s);
+    auto u = objective_vector_type{ov[0], ov[1], ov[2], ov[3]};
+    auto it = std::ranges::lower_bound(m_solution_set, u, lexicographically_greater_fn{});
+    if (it == m_solution_set.end() || *it != u) {
+      return 0;
+    }
 
-    auto u = new Point(p[0], p[1], p[2]);
+    m_solution_set.erase(it);
+    auto hvc = contribution(u, m_joins);
+    m_value -= hvc;
+    return hvc;
+  }
 
-    for (auto it = m_solution_set; it != NULL; it = it->next) {
-      if (m_lex_ge(it, u)) {
-        try_update_cnext(u, it);
-        try_update_cprev(u, it);
-      } else {
-        try_update_cnext(it, u);
-        try_update_cprev(it, u);
-      }
+  // Same as erase(s), but then inserts the points in `candidates`, such
+  // as the points that were removed for being dominated by s. Returns
+  // the decrease in value.
+  template <typename S, std::ranges::input_range C>
+  constexpr auto erase(S const& s, C const& candidates) -> value_type {
+    auto hvc = erase(s);
+    for (auto const& c : candidates) {
+      hvc -= insert(c);
     }
+    return hvc;
+  }
 
-    for (auto it = m_solution_set->next->next; it != NULL;) {
-      if (custom_weakly_dominates(u, it)) {
-        if (it->next != NULL) {
-          it->next->prev = it->prev;
-        }
-        if (it->prev != NULL) {
-          it->prev->next = it->next;
-        }
+ private:
+  using projection_type = std::array<value_type, 3>;
+  using hv3d_type = incremental_hv3dplus<value_type>;
 
-        auto aux = it->next;
-        delete it;
-        it = aux;
-      } else {
-        it = it->next;
-      }
+  template <typename S>
+  constexpr auto contribution(S const& s, hv3d_type& joins) const -> value_type {
+    if (!mooutils::strictly_dominates(s, m_reference)) {
+      return 0;
     }
 
-    // Insert u in q
-    auto prev = m_solution_set->next;
-    for (auto it = m_solution_set->next->next; it != NULL; it = it->next) {
-      if (m_lex_ge(u, it)) {
-        u->next = it;
-        u->prev = prev;
-        it->prev = u;
-        prev->next = u;
-        break;
+    auto const& u = mooutils::objective_vector(s);
+    auto join = [&u](auto const& q) {
+      return projection_type{std::min<value_type>(q[1], u[1]), std::min<value_type>(q[2], u[2]),
+                             std::min<value_type>(q[3], u[3])};
+    };
+    joins.clear();
+
+    // The points above u, where u is dominated if the projection of one
+    // of them weakly dominates the projection of u, which is checked
+    // exactly, instead of through the volumes
+    auto it = m_solution_set.begin();
+    for (; it != m_solution_set.end() && (*it)[0] >= u[0]; ++it) {
+      auto const& q = *it;
+      if (q[1] >= u[1] && q[2] >= u[2] && q[3] >= u[3]) {
+        return 0;
       }
-      prev = it;
-    }
-    if (prev->next == NULL) {
-      prev->next = u;
-      u->prev = prev;
+      joins.insert(join(q));
     }
 
-    return hvc;
-  }
+    auto c = (u[1] - m_reference[1]) * (u[2] - m_reference[2]) * (u[3] - m_reference[3]) - joins.value();
+    auto v = value_type{0};
+    auto z = value_type{u[0]};
+    for (; it != m_solution_set.end() && c > 0; ++it) {
+      auto const& q = *it;
+      v += c * (z - q[0]);
+      z = q[0];
+      c -= joins.insert(join(q));
+    }
+    v += c * (z - m_reference[0]);
 
-  auto m_lex_ge(Point* a, Point* b) {
-    return (a->z > b->z || (a->z == b->z && (a->y > b->y || (a->y == b->y && a->x >= b->x))));
+    return v;
   }
 
   value_type m_value;
   objective_vector_type m_reference;
-  Point* m_solution_set;
+  std::vector<objective_vector_type> m_solution_set;
+  // HV3D+ structure of the joint points, reused across calls
+  mutable hv3d_type m_joins;
 };
 
+// Incremental hypervolume for any number of objectives, which uses the
+// specialized structure for two, three and four objectives. When the
+// size of ObjectiveVector is static (see static_extent), the structure
+// is selected at compile time and stored directly, otherwise every
+// operation dispatches on the number of objectives.
 template <typename Value, typename ObjectiveVector>
 class [[nodiscard]] incremental_hv {
  public:
@@ -712,67 +1911,469 @@ class [[nodiscard]] incremental_hv {
   using objective_vector_type = ObjectiveVector;
 
   template <typename S>
-  incremental_hv(S&& s) {
-    auto const& ov = mooutils::objective_vector(s);
-    m_size = ov.size();
-    if (m_size < 2) {
-      throw("Size of objective vector must be at least 2");
-    } else if (m_size == 2) {
-      m_hv = decltype(m_hv)(std::in_place_index<1>, ov[0], ov[1]);
-      // m_hv.emplace<1>(ov[0], ov[1]);
-    } else if (m_size == 3) {
-      m_hv = decltype(m_hv)(std::in_place_index<2>, ov[0], ov[1], ov[2]);
-      // m_hv.emplace<2>(ov[0], ov[1], ov[2]);
-    } else {
-      m_hv = decltype(m_hv)(std::in_place_index<3>, ov);
-      // m_hv.emplace<3>(ov);
-    }
-  }
+  incremental_hv(S&& s)
+      : m_hv(make_hv(mooutils::objective_vector(s))) {}
 
   [[nodiscard]] constexpr auto value() const -> value_type {
-    if (m_size == 2) {
-      return std::get<1>(m_hv).value();
-    } else if (m_size == 3) {
-      return std::get<2>(m_hv).value();
-    } else {
-      return std::get<3>(m_hv).value();
-    }
-    return 0;
+    return visit([](auto const& hv) -> value_type { return hv.value(); });
   }
 
   template <typename S>
   [[nodiscard]] constexpr auto contribution(S const& s) const -> value_type {
-    if (m_size == 2) {
-      return std::get<1>(m_hv).contribution(s);
-    } else if (m_size == 3) {
-      return std::get<2>(m_hv).contribution(s);
-    } else {
-      return std::get<3>(m_hv).contribution(s);
-    }
-    return 0;
+    return visit([&s](auto const& hv) -> value_type { return hv.contribution(s); });
   }
 
   template <typename S>
   constexpr auto insert(S&& s) -> value_type {
-    if (m_size == 2) {
-      return std::get<1>(m_hv).insert(std::forward<S>(s));
-    } else if (m_size == 3) {
-      return std::get<2>(m_hv).insert(std::forward<S>(s));
-    } else {
-      return std::get<3>(m_hv).insert(std::forward<S>(s));
+    return visit([&s](auto& hv) -> value_type { return hv.insert(std::forward<S>(s)); });
+  }
+
+  template <typename S>
+  constexpr auto erase(S const& s) -> value_type {
+    return visit([&s](auto& hv) -> value_type { return hv.erase(s); });
+  }
+
+  template <typename S, std::ranges::input_range C>
+  constexpr auto erase(S const& s, C const& candidates) -> value_type {
+    auto c = erase(s);
+    for (auto const& v : candidates) {
+      c -= insert(v);
     }
-    return 0;
+    return c;
   }
 
  private:
   using hv2_type = incremental_hv2d<value_type>;
   using hv3_type = incremental_hv3dplus<value_type>;
+  using hv4_type = incremental_hv4dplus<value_type>;
   using hvd_type = incremental_hvwfg<value_type, objective_vector_type>;
 
-  size_t m_size;
-  std::variant<std::monostate, hv2_type, hv3_type, hvd_type> m_hv;
+  static constexpr auto static_size = static_extent_v<objective_vector_type>;
+  static_assert(static_size == std::dynamic_extent || static_size >= 2,
+                "Size of objective vector must be at least 2");
+
+  // clang-format off
+  using hv_type =
+    std::conditional_t<static_size == std::dynamic_extent,
+                       std::variant<std::monostate, hv2_type, hv3_type, hv4_type, hvd_type>,
+    std::conditional_t<static_size == 2, hv2_type,
+    std::conditional_t<static_size == 3, hv3_type,
+    std::conditional_t<static_size == 4, hv4_type, hvd_type>>>>;
+  // clang-format on
+
+  template <typename OV>
+  static auto make_hv(OV const& ov) -> hv_type {
+    if constexpr (std::same_as<hv_type, hv2_type>) {
+      return hv_type(ov[0], ov[1]);
+    } else if constexpr (std::same_as<hv_type, hv3_type>) {
+      return hv_type(ov[0], ov[1], ov[2]);
+    } else if constexpr (std::same_as<hv_type, hv4_type>) {
+      return hv_type(ov[0], ov[1], ov[2], ov[3]);
+    } else if constexpr (std::same_as<hv_type, hvd_type>) {
+      return hv_type(ov);
+    } else if (ov.size() < 2) {
+      throw("Size of objective vector must be at least 2");
+    } else if (ov.size() == 2) {
+      return hv_type(std::in_place_index<1>, ov[0], ov[1]);
+    } else if (ov.size() == 3) {
+      return hv_type(std::in_place_index<2>, ov[0], ov[1], ov[2]);
+    } else if (ov.size() == 4) {
+      return hv_type(std::in_place_index<3>, ov[0], ov[1], ov[2], ov[3]);
+    } else {
+      return hv_type(std::in_place_index<4>, ov);
+    }
+  }
+
+  // Calls `f` with the structure, which is only a run-time dispatch
+  // when the number of objectives is dynamic. The variant is never
+  // valueless, since the structure is only assigned on construction.
+  template <typename F>
+  constexpr auto visit(F&& f) const -> value_type {
+    return visit_impl(m_hv, std::forward<F>(f));
+  }
+
+  template <typename F>
+  constexpr auto visit(F&& f) -> value_type {
+    return visit_impl(m_hv, std::forward<F>(f));
+  }
+
+  template <typename HV, typename F>
+  static constexpr auto visit_impl(HV& hv, F&& f) -> value_type {
+    if constexpr (static_size != std::dynamic_extent) {
+      return f(hv);
+    } else {
+      switch (hv.index()) {
+        case 1:
+          return f(std::get<1>(hv));
+        case 2:
+          return f(std::get<2>(hv));
+        case 3:
+          return f(std::get<3>(hv));
+        default:
+          return f(std::get<4>(hv));
+      }
+    }
+  }
+
+  hv_type m_hv;
 };
 
+// Hypervolume subset selection: select k points of a set such that the
+// hypervolume of the selected points is as large as possible. All the
+// functions below return the indices (w.r.t. the order of the points
+// in the set) of min(k, n) selected points in increasing order.
+
+// Exact subset selection for two objectives, with the dynamic
+// programming algorithm of "K. Bringmann, T. Friedrich, and P. Klitzke,
+// "Two-dimensional subset selection for hypervolume and epsilon-
+// indicator," in Proceedings of the 2014 Annual Conference on Genetic
+// and Evolutionary Computation, pp. 589-596, 2014."
+//
+// The non-dominated points are sorted in decreasing order of the first
+// objective, and f[j][i] is the largest hypervolume of j points of
+// which point i is the last one. Then f[j][i] = max_l f[j-1][l] + x_i *
+// (y_i - y_l), with l < i, is the upper envelope of the lines with
+// slope -y_l and intercept f[j-1][l] at x_i. Since both the slopes and
+// the queries are monotone, each layer is computed in O(n) time with
+// the convex hull trick, for a total of O(n log n + kn) time. The
+// selection is recovered with O(n sqrt(k)) additional memory (see
+// below), instead of the O(kn) of a table of all the choices.
+template <typename T>
+struct hv_subset_select2d_fn {
+  template <is_objective_vector_set S, is_objective_vector R>
+  [[nodiscard]] constexpr auto operator()(S const& set, R const& r, size_t k) const -> std::vector<size_t> {
+    // Points relative to the reference point, such that the hypervolume
+    // of a point is the product of its coordinates
+    using ov_type = std::array<T, 2>;
+    auto points = std::vector<ov_type>();
+    points.reserve(set.size());
+    for (auto const& v : objective_vectors(set)) {
+      points.push_back(ov_type{T{v[0]} - T{r[0]}, T{v[1]} - T{r[1]}});
+    }
+
+    // Indices of the non-dominated points that contribute to the
+    // hypervolume, in decreasing order of the first objective
+    auto order = std::vector<size_t>(points.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::ranges::sort(order, [&points](auto i, auto j) {
+      return points[i][0] > points[j][0] || (points[i][0] == points[j][0] && points[i][1] > points[j][1]);
+    });
+    auto front = std::vector<size_t>();
+    auto ymax = T{0};
+    for (auto i : order) {
+      if (points[i][0] > 0 && points[i][1] > ymax) {
+        front.push_back(i);
+        ymax = points[i][1];
+      }
+    }
+
+    if (k >= front.size()) {
+      return fill(std::move(front), points.size(), k);
+    }
+    if (k == 0) {
+      return {};
+    }
+
+    auto const n = front.size();
+    auto x = [&](size_t i) { return points[front[i]][0]; };
+    auto y = [&](size_t i) { return points[front[i]][1]; };
+
+    // Point i can only be the j-th of k selected points if there are at
+    // least k - j points after it, so layer j is only computed for the
+    // w = n - k + 1 points j - 1, ..., n - k + j - 1. Computes layer j
+    // from layer j - 1, and stores the parents of its points (the point
+    // before them in the best selection of j points that ends in them)
+    // if given.
+    auto const w = n - k + 1;
+    auto hull = std::vector<size_t>(w);
+    auto layer = [&](std::vector<T> const& prev, std::vector<T>& curr, size_t j, uint32_t* parent) {
+      auto line = [&](size_t l, T const& q) { return prev[l] - q * y(l); };
+      // Line b is not needed on the upper envelope of lines a and c
+      // with a < b < c
+      auto bad = [&](size_t a, size_t b, size_t c) {
+        return (prev[b] - prev[a]) * (y(c) - y(b)) <= (prev[c] - prev[b]) * (y(b) - y(a));
+      };
+
+      size_t first = 0;
+      size_t last = 0;
+      for (size_t i = j - 1; i < j - 1 + w; ++i) {
+        auto l = i - 1;
+        while (last - first >= 2 && bad(hull[last - 2], hull[last - 1], l)) {
+          --last;
+        }
+        hull[last++] = l;
+        while (last - first >= 2 && line(hull[first + 1], x(i)) >= line(hull[first], x(i))) {
+          ++first;
+        }
+        curr[i] = line(hull[first], x(i)) + x(i) * y(i);
+        if (parent != nullptr) {
+          parent[i - (j - 1)] = static_cast<uint32_t>(hull[first]);
+        }
+      }
+    };
+
+    // Keeping the parents of every layer would take O(kn) memory, so
+    // only every b-th layer is kept while computing the layers, in
+    // blocks of b = sqrt(k) layers. Then the selection is traced back
+    // one block at a time, computing the layers of the block again from
+    // its first one to get their parents. This takes O(n sqrt(k))
+    // memory, for twice the time.
+    assert(n <= std::numeric_limits<uint32_t>::max());
+    auto b = size_t{1};
+    while (b * b < k) {
+      ++b;
+    }
+    auto prev = std::vector<T>(n);
+    auto curr = std::vector<T>(n);
+    for (size_t i = 0; i < n; ++i) {
+      prev[i] = x(i) * y(i);
+    }
+    auto checkpoints = std::vector<std::vector<T>>();
+    for (size_t j = 1; j <= k; ++j) {
+      if (j > 1) {
+        layer(prev, curr, j, nullptr);
+        std::swap(prev, curr);
+      }
+      if ((j - 1) % b == 0) {
+        checkpoints.push_back(prev);
+      }
+    }
+
+    auto i = k - 1;
+    for (auto l = k; l < n; ++l) {
+      if (prev[l] > prev[i]) {
+        i = l;
+      }
+    }
+    auto res = std::vector<size_t>(k);
+    auto parent = std::vector<uint32_t>(b * w);
+    for (auto c = checkpoints.size(); c-- > 0;) {
+      auto const jb = 1 + c * b;
+      auto const top = std::min(k, jb + b);
+      prev = std::move(checkpoints[c]);
+      for (auto j = jb + 1; j <= top; ++j) {
+        layer(prev, curr, j, parent.data() + (j - jb - 1) * w);
+        std::swap(prev, curr);
+      }
+      for (auto j = top; j > jb; --j) {
+        res[j - 1] = front[i];
+        i = parent[(j - jb - 1) * w + (i - (j - 1))];
+      }
+    }
+    res[0] = front[i];
+    std::ranges::sort(res);
+    return res;
+  }
+
+ private:
+  // All the points in `front` and, while there are less than k, the
+  // remaining points in increasing order of their indices.
+  [[nodiscard]] static constexpr auto fill(std::vector<size_t> front, size_t n, size_t k) -> std::vector<size_t> {
+    std::ranges::sort(front);
+    auto res = std::vector<size_t>();
+    res.reserve(std::min(k, n));
+    auto it = front.begin();
+    for (size_t i = 0; i < n && res.size() < k; ++i) {
+      if (it != front.end() && *it == i) {
+        ++it;
+        res.push_back(i);
+      } else if (res.size() + static_cast<size_t>(front.end() - it) < k) {
+        res.push_back(i);
+      }
+    }
+    return res;
+  }
+};
+
+template <typename T>
+inline constexpr hv_subset_select2d_fn<T> hv_subset_select2d;
+
+// Greedy forward selection: starting from the empty set, adds the point
+// with the largest hypervolume contribution until k points are
+// selected, with ties broken by the smallest index.
+//
+// The contributions are kept in a priority queue and updated lazily, as
+// in the CELF algorithm of "J. Leskovec et al., "Cost-effective
+// Outbreak Detection in Networks," in Proceedings of the 13th ACM
+// SIGKDD International Conference on Knowledge Discovery and Data
+// Mining, pp. 420-429, 2007." Since the hypervolume is submodular, the
+// contribution of a point can only decrease as more points are
+// selected, so an outdated contribution is an upper bound. Therefore,
+// only the contribution at the top of the queue needs to be recomputed
+// (with an incremental_hv structure), and the point is selected once
+// its contribution is up to date.
+template <typename T>
+struct hv_subset_select_forward_fn {
+  template <is_objective_vector_set S, is_objective_vector R>
+  [[nodiscard]] constexpr auto operator()(S const& set, R const& r, size_t k) const -> std::vector<size_t> {
+    auto const ref = std::vector<T>(r.begin(), r.end());
+    auto points = std::vector<std::vector<T>>();
+    points.reserve(set.size());
+    for (auto const& v : objective_vectors(set)) {
+      points.emplace_back(v.begin(), v.end());
+    }
+
+    struct entry {
+      T contribution;
+      size_t index;
+      size_t round;
+    };
+    auto cmp = [](entry const& a, entry const& b) {
+      return a.contribution < b.contribution || (a.contribution == b.contribution && a.index > b.index);
+    };
+
+    auto hv = incremental_hv<T, std::vector<T>>(ref);
+    auto queue = std::vector<entry>();
+    queue.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+      queue.push_back(entry{hv.contribution(points[i]), i, 0});
+    }
+    std::ranges::make_heap(queue, cmp);
+
+    auto res = std::vector<size_t>();
+    res.reserve(std::min(k, points.size()));
+    while (res.size() < k && !queue.empty()) {
+      std::ranges::pop_heap(queue, cmp);
+      auto& e = queue.back();
+      // A contribution of zero can not decrease any further
+      if (e.round == res.size() || e.contribution == T{0}) {
+        hv.insert(points[e.index]);
+        res.push_back(e.index);
+        queue.pop_back();
+      } else {
+        e.contribution = hv.contribution(points[e.index]);
+        e.round = res.size();
+        std::ranges::push_heap(queue, cmp);
+      }
+    }
+    std::ranges::sort(res);
+    return res;
+  }
+};
+
+template <typename T>
+inline constexpr hv_subset_select_forward_fn<T> hv_subset_select_forward;
+
+// Greedy backward elimination: starting from the whole set, removes the
+// point with the smallest hypervolume contribution until k points are
+// left. The points that are dominated by (or equal to) another point
+// are removed first, since they contribute nothing.
+//
+// The contributions are updated lazily, as in
+// hv_subset_select_forward. Here, the contribution of a point can only
+// increase as other points are removed, so an outdated contribution is
+// a lower bound. The point at the top of the queue is removed from the
+// incremental_hv structure, which gives its current contribution, and
+// is inserted back only if that is larger than the next lower bound.
+template <typename T>
+struct hv_subset_select_backward_fn {
+  template <is_objective_vector_set S, is_objective_vector R>
+  [[nodiscard]] constexpr auto operator()(S const& set, R const& r, size_t k) const -> std::vector<size_t> {
+    auto const ref = std::vector<T>(r.begin(), r.end());
+    auto points = std::vector<std::vector<T>>();
+    points.reserve(set.size());
+    for (auto const& v : objective_vectors(set)) {
+      points.emplace_back(v.begin(), v.end());
+    }
+
+    // A point can only be weakly dominated by the points that come
+    // before it in decreasing lexicographical order
+    auto order = std::vector<size_t>(points.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::ranges::sort(order, [&points](auto i, auto j) {
+      return lexicographically_greater(points[i], points[j]) || (points[i] == points[j] && i < j);
+    });
+    auto front = std::vector<size_t>();
+    for (auto i : order) {
+      if (std::ranges::none_of(front, [&](auto j) { return weakly_dominates(points[j], points[i]); })) {
+        front.push_back(i);
+      }
+    }
+
+    auto keep = std::vector<bool>(points.size(), false);
+    if (front.size() <= k) {
+      for (auto i : front) {
+        keep[i] = true;
+      }
+      for (size_t i = 0, c = front.size(); i < points.size() && c < k; ++i) {
+        if (!keep[i]) {
+          keep[i] = true;
+          ++c;
+        }
+      }
+    } else {
+      struct entry {
+        T contribution;
+        size_t index;
+      };
+      auto cmp = [](entry const& a, entry const& b) {
+        return a.contribution > b.contribution || (a.contribution == b.contribution && a.index < b.index);
+      };
+
+      auto hv = incremental_hv<T, std::vector<T>>(ref);
+      auto front_points = std::vector<std::vector<T>>();
+      front_points.reserve(front.size());
+      for (auto i : front) {
+        hv.insert(points[i]);
+        front_points.push_back(points[i]);
+      }
+      auto contributions = hv_contributions<T>(front_points, ref);
+
+      auto queue = std::vector<entry>();
+      queue.reserve(front.size());
+      for (size_t i = 0; i < front.size(); ++i) {
+        queue.push_back(entry{contributions[i], front[i]});
+        keep[front[i]] = true;
+      }
+      std::ranges::make_heap(queue, cmp);
+
+      for (auto size = front.size(); size > k;) {
+        std::ranges::pop_heap(queue, cmp);
+        auto e = queue.back();
+        queue.pop_back();
+        auto c = hv.erase(points[e.index]);
+        if (c == e.contribution || queue.empty() || c <= queue.front().contribution) {
+          keep[e.index] = false;
+          --size;
+        } else {
+          hv.insert(points[e.index]);
+          queue.push_back(entry{c, e.index});
+          std::ranges::push_heap(queue, cmp);
+        }
+      }
+    }
+
+    auto res = std::vector<size_t>();
+    res.reserve(std::min(k, points.size()));
+    for (size_t i = 0; i < points.size(); ++i) {
+      if (keep[i]) {
+        res.push_back(i);
+      }
+    }
+    return res;
+  }
+};
+
+template <typename T>
+inline constexpr hv_subset_select_backward_fn<T> hv_subset_select_backward;
+
+// Dispatches to the exact hv_subset_select2d for two objectives, and to
+// the greedy hv_subset_select_forward otherwise.
+template <typename T>
+struct hv_subset_select_fn {
+  template <is_objective_vector_set S, is_objective_vector R>
+  [[nodiscard]] constexpr auto operator()(S const& set, R const& r, size_t k) const -> std::vector<size_t> {
+    if (r.size() == 2) {
+      return hv_subset_select2d<T>(set, r, k);
+    } else {
+      return hv_subset_select_forward<T>(set, r, k);
+    }
+  }
+};
+
+template <typename T>
+inline constexpr hv_subset_select_fn<T> hv_subset_select;
+
 }  // namespace mooutils
 
 #endif
@@ -0,0 +1,764 @@
+#ifndef MOOUTILS_IO_HPP_
+#define MOOUTILS_IO_HPP_
+
+#include "concepts.hpp"
+#include "solution.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<sys/mman.h>) && __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MOOUTILS_MMAP 1
+#endif
+
+namespace mooutils {
+
+// Binary front format
+//
+// A front file starts with a 64 byte header, with the fields below in
+// little-endian order, followed by the reference point (if any) and by
+// the payload, which starts at an offset multiple of 64 bytes:
+//
+//   offset  size  field
+//        0     8  magic "MOOFRONT"
+//        8     4  version (1)
+//       12     1  scalar type (front_scalar_type)
+//       13     1  layout (front_layout)
+//       14     1  whether there is a reference point
+//       15     1  reserved (0)
+//       16     8  number of points (n)
+//       24     8  number of objectives (m)
+//       32     8  offset of the payload
+//       40    24  reserved (0)
+//
+// The payload has n * m values, either by point (rows), such that each
+// objective vector is contiguous, or by objective (columns), such that
+// the values of each objective are contiguous, as in a structure of
+// arrays. Since the values are aligned in the file, a mapped file can
+// be used directly, without parsing or copying it.
+
+enum class front_scalar_type : uint8_t {
+  int8 = 1,
+  int16 = 2,
+  int32 = 3,
+  int64 = 4,
+  uint8 = 5,
+  uint16 = 6,
+  uint32 = 7,
+  uint64 = 8,
+  float32 = 9,
+  float64 = 10,
+};
+
+enum class front_layout : uint8_t {
+  rows = 0,
+  columns = 1,
+};
+
+template <typename T>
+requires std::is_arithmetic_v<T> && (!std::same_as<T, bool>)
+inline constexpr front_scalar_type front_scalar_type_v = [] {
+  if constexpr (std::is_floating_point_v<T>) {
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Unsupported floating point type");
+    return sizeof(T) == 4 ? front_scalar_type::float32 : front_scalar_type::float64;
+  } else {
+    constexpr auto log2 = std::countr_zero(sizeof(T));
+    static_assert(log2 < 4, "Unsupported integer type");
+    return static_cast<front_scalar_type>((std::is_signed_v<T> ? 1 : 5) + log2);
+  }
+}();
+
+struct front_header {
+  static constexpr auto magic = std::array<char, 8>{'M', 'O', 'O', 'F', 'R', 'O', 'N', 'T'};
+  static constexpr uint32_t version = 1;
+  static constexpr size_t size = 64;
+
+  front_scalar_type scalar_type;
+  front_layout layout;
+  bool has_reference;
+  uint64_t n;
+  uint64_t m;
+  uint64_t payload_offset;
+
+  [[nodiscard]] auto serialize() const -> std::array<std::byte, size> {
+    auto res = std::array<std::byte, size>{};
+    auto put = [&res](size_t offset, auto value) { std::memcpy(res.data() + offset, &value, sizeof(value)); };
+    std::memcpy(res.data(), magic.data(), magic.size());
+    put(8, version);
+    put(12, scalar_type);
+    put(13, layout);
+    put(14, static_cast<uint8_t>(has_reference));
+    put(16, n);
+    put(24, m);
+    put(32, payload_offset);
+    return res;
+  }
+
+  [[nodiscard]] static auto deserialize(std::span<std::byte const> bytes) -> front_header {
+    auto get = [&bytes]<typename V>(size_t offset, V value) {
+      std::memcpy(&value, bytes.data() + offset, sizeof(value));
+      return value;
+    };
+    if (bytes.size() < size || std::memcmp(bytes.data(), magic.data(), magic.size()) != 0) {
+      throw std::runtime_error("Not a front file");
+    }
+    if (get(8, uint32_t{}) != version) {
+      throw std::runtime_error("Unsupported front file version");
+    }
+    auto res = front_header{get(12, front_scalar_type{}), get(13, front_layout{}), get(14, uint8_t{}) != 0,
+                            get(16, uint64_t{}), get(24, uint64_t{}), get(32, uint64_t{})};
+    if (res.layout != front_layout::rows && res.layout != front_layout::columns) {
+      throw std::runtime_error("Invalid front file layout");
+    }
+    return res;
+  }
+};
+
+// Writes the objective vectors of a set to a front file, with values of
+// type T, and optionally a reference point.
+template <typename T>
+requires std::is_arithmetic_v<T> && (!std::same_as<T, bool>)
+struct write_front_fn {
+  template <is_objective_vector_set S>
+  requires std::ranges::forward_range<S>
+  auto operator()(std::filesystem::path const& path, S const& set, front_layout layout = front_layout::rows) const
+      -> void {
+    write(path, set, std::span<T const>(), layout);
+  }
+
+  template <is_objective_vector_set S, is_objective_vector R>
+  requires std::ranges::forward_range<S>
+  auto operator()(std::filesystem::path const& path, S const& set, R const& reference,
+                  front_layout layout = front_layout::rows) const -> void {
+    auto r = std::vector<T>(std::ranges::begin(reference), std::ranges::end(reference));
+    write(path, set, std::span<T const>(r), layout, true);
+  }
+
+ private:
+  template <typename S>
+  static auto write(std::filesystem::path const& path, S const& set, std::span<T const> reference,
+                    front_layout layout, bool has_reference = false) -> void {
+    static_assert(std::endian::native == std::endian::little, "Front files are little-endian");
+
+    auto const n = static_cast<uint64_t>(std::ranges::size(set));
+    auto const m = n > 0 ? static_cast<uint64_t>(std::ranges::size(objective_vector(*std::ranges::begin(set))))
+                         : static_cast<uint64_t>(reference.size());
+    if (has_reference && reference.size() != m) {
+      throw std::invalid_argument("Reference point and objective vectors have different sizes");
+    }
+    auto const reference_end = front_header::size + (has_reference ? m * sizeof(T) : 0);
+    auto const header = front_header{front_scalar_type_v<T>, layout, has_reference, n, m,
+                                     (reference_end + 63) / 64 * 64};
+
+    auto os = std::ofstream(path, std::ios::binary | std::ios::trunc);
+    if (!os) {
+      throw std::runtime_error("Can't open file " + path.string());
+    }
+    auto const bytes = header.serialize();
+    os.write(reinterpret_cast<char const*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    os.write(reinterpret_cast<char const*>(reference.data()), static_cast<std::streamsize>(reference.size_bytes()));
+    auto const padding = std::array<char, 64>{};
+    os.write(padding.data(), static_cast<std::streamsize>(header.payload_offset - reference_end));
+
+    // Values are buffered, such that the file is written in large blocks
+    auto buffer = std::vector<T>();
+    buffer.reserve(std::max<size_t>(m, 1 << 16));
+    auto flush = [&os, &buffer](bool force) {
+      if (force || buffer.size() + 1 > buffer.capacity()) {
+        os.write(reinterpret_cast<char const*>(buffer.data()),
+                 static_cast<std::streamsize>(buffer.size() * sizeof(T)));
+        buffer.clear();
+      }
+    };
+    if (layout == front_layout::rows) {
+      for (auto const& s : set) {
+        auto const& ov = objective_vector(s);
+        if (static_cast<uint64_t>(std::ranges::size(ov)) != m) {
+          throw std::invalid_argument("Objective vectors have different sizes");
+        }
+        if (buffer.size() + m > buffer.capacity()) {
+          flush(true);
+        }
+        for (auto const& v : ov) {
+          buffer.push_back(static_cast<T>(v));
+        }
+      }
+    } else {
+      for (uint64_t j = 0; j < m; ++j) {
+        for (auto const& s : set) {
+          auto const& ov = objective_vector(s);
+          if (static_cast<uint64_t>(std::ranges::size(ov)) != m) {
+            throw std::invalid_argument("Objective vectors have different sizes");
+          }
+          buffer.push_back(static_cast<T>(std::ranges::begin(ov)[static_cast<std::ptrdiff_t>(j)]));
+          flush(false);
+        }
+      }
+    }
+    flush(true);
+    if (!os) {
+      throw std::runtime_error("Can't write file " + path.string());
+    }
+  }
+};
+
+template <typename T>
+inline constexpr write_front_fn<T> write_front;
+
+// Read-only view of a front file, which is memory-mapped when possible
+// (otherwise it is read into memory), such that fronts larger than the
+// available memory can be used without copying them.
+//
+// For the rows layout, the front is a random access range of
+// std::span<T const> objective vectors into the file, which satisfies
+// is_objective_vector_set, such that it can be given to the indicators,
+// orders and sets directly. The iterator returns the span of a row by
+// value, which refers to the file and not to the iterator, so it stays
+// valid as long as the front. A front with the columns layout can't be
+// used as a range (begin, end, size and empty throw std::logic_error),
+// instead the number of points is given by points(), and the values of
+// each objective by column(j).
+template <typename T>
+requires std::is_arithmetic_v<T> && (!std::same_as<T, bool>)
+class mapped_front {
+ private:
+  // The bytes of a file, either mapped or read into an aligned buffer,
+  // which are released when the mapping is destroyed
+  class mapping {
+   public:
+    mapping() = default;
+
+    explicit mapping(std::filesystem::path const& path)
+        : m_size(std::filesystem::file_size(path)) {
+#ifdef MOOUTILS_MMAP
+      if (m_size > 0) {
+        auto const fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+          throw std::runtime_error("Can't open file " + path.string());
+        }
+        auto* p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p != MAP_FAILED) {
+          m_bytes = static_cast<std::byte const*>(p);
+          return;
+        }
+      }
+#endif
+      // Read the file instead, into a buffer aligned for any scalar type
+      m_buffer.resize((m_size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t) + 1);
+      auto is = std::ifstream(path, std::ios::binary);
+      if (!is.read(reinterpret_cast<char*>(m_buffer.data()), static_cast<std::streamsize>(m_size))) {
+        throw std::runtime_error("Can't read file " + path.string());
+      }
+      m_bytes = reinterpret_cast<std::byte const*>(m_buffer.data());
+    }
+
+    mapping(mapping&& other) noexcept
+        : m_bytes(std::exchange(other.m_bytes, nullptr))
+        , m_size(std::exchange(other.m_size, 0))
+        , m_buffer(std::move(other.m_buffer)) {}
+
+    auto operator=(mapping&& other) noexcept -> mapping& {
+      std::swap(m_bytes, other.m_bytes);
+      std::swap(m_size, other.m_size);
+      std::swap(m_buffer, other.m_buffer);
+      return *this;
+    }
+
+    mapping(mapping const&) = delete;
+    auto operator=(mapping const&) -> mapping& = delete;
+
+    ~mapping() {
+#ifdef MOOUTILS_MMAP
+      if (m_bytes != nullptr && m_buffer.empty()) {
+        ::munmap(const_cast<std::byte*>(m_bytes), m_size);
+      }
+#endif
+    }
+
+    [[nodiscard]] auto bytes() const -> std::span<std::byte const> {
+      return std::span<std::byte const>(m_bytes, m_size);
+    }
+
+   private:
+    std::byte const* m_bytes = nullptr;
+    size_t m_size = 0;
+    std::vector<std::max_align_t> m_buffer;
+  };
+
+ public:
+  using value_type = std::span<T const>;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+
+  // Random access iterator over the rows, which builds the span of a row
+  // from its index when it is dereferenced and returns it by value
+  class iterator {
+   public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::span<T const>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::span<T const>;
+
+    iterator() = default;
+
+    iterator(T const* data, size_t m, size_t i)
+        : m_data(data)
+        , m_m(m)
+        , m_i(i) {}
+
+    [[nodiscard]] auto operator*() const -> reference {
+      return std::span<T const>(m_data + m_i * m_m, m_m);
+    }
+
+    [[nodiscard]] auto operator[](difference_type d) const -> reference {
+      return std::span<T const>(m_data + (m_i + static_cast<size_t>(d)) * m_m, m_m);
+    }
+
+    auto operator++() -> iterator& {
+      ++m_i;
+      return *this;
+    }
+
+    auto operator++(int) -> iterator {
+      auto res = *this;
+      ++m_i;
+      return res;
+    }
+
+    auto operator--() -> iterator& {
+      --m_i;
+      return *this;
+    }
+
+    auto operator--(int) -> iterator {
+      auto res = *this;
+      --m_i;
+      return res;
+    }
+
+    auto operator+=(difference_type d) -> iterator& {
+      m_i += static_cast<size_t>(d);
+      return *this;
+    }
+
+    auto operator-=(difference_type d) -> iterator& {
+      m_i -= static_cast<size_t>(d);
+      return *this;
+    }
+
+    [[nodiscard]] friend auto operator+(iterator it, difference_type d) -> iterator {
+      return it += d;
+    }
+
+    [[nodiscard]] friend auto operator+(difference_type d, iterator it) -> iterator {
+      return it += d;
+    }
+
+    [[nodiscard]] friend auto operator-(iterator it, difference_type d) -> iterator {
+      return it -= d;
+    }
+
+    [[nodiscard]] friend auto operator-(iterator const& lhs, iterator const& rhs) -> difference_type {
+      return static_cast<difference_type>(lhs.m_i) - static_cast<difference_type>(rhs.m_i);
+    }
+
+    [[nodiscard]] friend auto operator==(iterator const& lhs, iterator const& rhs) -> bool {
+      return lhs.m_i == rhs.m_i;
+    }
+
+    [[nodiscard]] friend auto operator<=>(iterator const& lhs, iterator const& rhs) -> std::strong_ordering {
+      return lhs.m_i <=> rhs.m_i;
+    }
+
+   private:
+    T const* m_data = nullptr;
+    size_t m_m = 0;
+    size_t m_i = 0;
+  };
+
+  using const_iterator = iterator;
+
+  explicit mapped_front(std::filesystem::path const& path)
+      : m_mapping(path) {
+    static_assert(std::endian::native == std::endian::little, "Front files are little-endian");
+    auto const bytes = m_mapping.bytes();
+    m_header = front_header::deserialize(bytes);
+    if (m_header.scalar_type != front_scalar_type_v<T>) {
+      throw std::runtime_error("Front file has a different scalar type");
+    }
+    // The fields are checked in an order such that none of the
+    // computations overflows
+    auto const size = static_cast<uint64_t>(bytes.size());
+    if (m_header.m > size / sizeof(T) || m_header.payload_offset % 64 != 0 || m_header.payload_offset > size) {
+      throw std::runtime_error("Front file is truncated or corrupted");
+    }
+    auto const row_size = m_header.m * sizeof(T);
+    auto const reference_end = front_header::size + (m_header.has_reference ? row_size : 0);
+    if (m_header.payload_offset < reference_end || (m_header.m == 0 && m_header.n > 0) ||
+        (m_header.m > 0 && m_header.n > (size - m_header.payload_offset) / row_size)) {
+      throw std::runtime_error("Front file is truncated or corrupted");
+    }
+  }
+
+  [[nodiscard]] auto layout() const -> front_layout {
+    return m_header.layout;
+  }
+
+  // Number of objectives
+  [[nodiscard]] auto objectives() const -> size_t {
+    return m_header.m;
+  }
+
+  [[nodiscard]] auto has_reference() const -> bool {
+    return m_header.has_reference;
+  }
+
+  [[nodiscard]] auto reference() const -> std::span<T const> {
+    assert(has_reference());
+    return std::span<T const>(reinterpret_cast<T const*>(m_mapping.bytes().data() + front_header::size),
+                              m_header.m);
+  }
+
+  // Values of objective j of every point (columns layout only)
+  [[nodiscard]] auto column(size_t j) const -> std::span<T const> {
+    assert(layout() == front_layout::columns);
+    assert(j < m_header.m);
+    return std::span<T const>(payload() + j * m_header.n, m_header.n);
+  }
+
+  // All the values in the order of the layout
+  [[nodiscard]] auto values() const -> std::span<T const> {
+    return std::span<T const>(payload(), m_header.n * m_header.m);
+  }
+
+  // The objective vectors (rows layout only)
+  [[nodiscard]] auto begin() const -> const_iterator {
+    check_rows();
+    return iterator(payload(), m_header.m, 0);
+  }
+
+  [[nodiscard]] auto end() const -> const_iterator {
+    check_rows();
+    return iterator(payload(), m_header.m, m_header.n);
+  }
+
+  [[nodiscard]] auto operator[](size_t i) const -> std::span<T const> {
+    assert(layout() == front_layout::rows);
+    assert(i < size());
+    return std::span<T const>(payload() + i * m_header.m, m_header.m);
+  }
+
+  // Number of objective vectors in the range (rows layout only, see
+  // points)
+  [[nodiscard]] auto size() const -> size_type {
+    check_rows();
+    return m_header.n;
+  }
+
+  [[nodiscard]] auto empty() const -> bool {
+    check_rows();
+    return m_header.n == 0;
+  }
+
+  // Number of points, for either layout
+  [[nodiscard]] auto points() const -> size_t {
+    return m_header.n;
+  }
+
+ private:
+  [[nodiscard]] auto payload() const -> T const* {
+    return reinterpret_cast<T const*>(m_mapping.bytes().data() + m_header.payload_offset);
+  }
+
+  // The range of objective vectors is only defined for the rows layout,
+  // such that a front with the columns layout is not silently taken as
+  // an empty set
+  auto check_rows() const -> void {
+    if (m_header.layout != front_layout::rows) {
+      throw std::logic_error("Front file with the columns layout is not a range of objective vectors");
+    }
+  }
+
+  mapping m_mapping;
+  front_header m_header = {};
+};
+
+// Text front format (hvdata)
+//
+// A text front file has the number of points (n) and of objectives (m),
+// the hypervolume of the front, the reference point, and the n objective
+// vectors, all separated by whitespace:
+//
+//   n m
+//   hv
+//   r_1 ... r_m
+//   v_11 ... v_1m
+//   ...
+//   v_n1 ... v_nm
+//
+// Values are parsed with std::from_chars and written with std::to_chars
+// (shortest round-trip representation for floating point), and the file
+// is read in large blocks, such that large files can be read much faster
+// than with iostreams.
+
+// Streaming reader of a text front file, with values of type T and a
+// hypervolume of type H. The reader is an input range of the objective
+// vectors, which are read one at a time, such that they can be inserted
+// into a set or an incremental indicator without keeping the whole file
+// in memory. The objective vector given by the iterator is overwritten
+// when the iterator is incremented.
+template <typename T, typename H = T>
+requires std::is_arithmetic_v<T> && std::is_arithmetic_v<H>
+class hvdata_reader {
+ public:
+  class iterator {
+   public:
+    using iterator_concept = std::input_iterator_tag;
+    using value_type = std::vector<T>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::vector<T> const&;
+
+    iterator() = default;
+
+    explicit iterator(hvdata_reader* reader)
+        : m_reader(reader) {}
+
+    [[nodiscard]] auto operator*() const -> reference {
+      return m_reader->m_point;
+    }
+
+    auto operator++() -> iterator& {
+      m_reader->advance();
+      return *this;
+    }
+
+    auto operator++(int) -> void {
+      ++*this;
+    }
+
+    [[nodiscard]] friend auto operator==(iterator const& it, std::default_sentinel_t) -> bool {
+      return it.at_end();
+    }
+
+   private:
+    [[nodiscard]] auto at_end() const -> bool {
+      return !m_reader->m_has_point;
+    }
+
+    hvdata_reader* m_reader = nullptr;
+  };
+
+  explicit hvdata_reader(std::filesystem::path const& path, size_t buffer_size = 1 << 20)
+      : m_is(path, std::ios::binary)
+      , m_buffer(std::max<size_t>(buffer_size, 64)) {
+    if (!m_is) {
+      throw std::runtime_error("Can't open file " + path.string());
+    }
+    m_n = parse<size_t>();
+    m_m = parse<size_t>();
+    m_hv = parse<H>();
+    m_reference.resize(m_m);
+    for (auto& v : m_reference) {
+      v = parse<T>();
+    }
+    m_point.resize(m_m);
+    advance();
+  }
+
+  hvdata_reader(hvdata_reader const&) = delete;
+  auto operator=(hvdata_reader const&) -> hvdata_reader& = delete;
+
+  // Number of points in the file
+  [[nodiscard]] auto points() const -> size_t {
+    return m_n;
+  }
+
+  // Number of objectives
+  [[nodiscard]] auto objectives() const -> size_t {
+    return m_m;
+  }
+
+  [[nodiscard]] auto hv() const -> H {
+    return m_hv;
+  }
+
+  [[nodiscard]] auto reference() const -> std::vector<T> const& {
+    return m_reference;
+  }
+
+  // The iterator refers to the reader, so the points can only be
+  // iterated once
+  [[nodiscard]] auto begin() -> iterator {
+    return iterator(this);
+  }
+
+  [[nodiscard]] auto end() const -> std::default_sentinel_t {
+    return std::default_sentinel;
+  }
+
+ private:
+  [[nodiscard]] static constexpr auto is_space(char c) -> bool {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+  }
+
+  auto advance() -> void {
+    m_has_point = m_read < m_n;
+    if (m_has_point) {
+      for (auto& v : m_point) {
+        v = parse<T>();
+      }
+      ++m_read;
+    }
+  }
+
+  // Moves the bytes not yet parsed to the start of the buffer and reads
+  // the next block after them, growing the buffer if it is full. Returns
+  // whether any byte was read.
+  auto fill() -> bool {
+    std::memmove(m_buffer.data(), m_buffer.data() + m_pos, m_end - m_pos);
+    m_end -= m_pos;
+    m_pos = 0;
+    if (m_end == m_buffer.size()) {
+      m_buffer.resize(m_buffer.size() * 2);
+    }
+    m_is.read(m_buffer.data() + m_end, static_cast<std::streamsize>(m_buffer.size() - m_end));
+    auto const count = static_cast<size_t>(m_is.gcount());
+    m_end += count;
+    return count > 0;
+  }
+
+  template <typename V>
+  auto parse() -> V {
+    while (true) {
+      while (m_pos < m_end && is_space(m_buffer[m_pos])) {
+        ++m_pos;
+      }
+      if (m_pos < m_end) {
+        break;
+      }
+      if (!fill()) {
+        throw std::runtime_error("Front file is truncated");
+      }
+    }
+    auto last = m_pos;
+    while (true) {
+      while (last < m_end && !is_space(m_buffer[last])) {
+        ++last;
+      }
+      // A value may continue in the next block, unless it is the last one
+      auto const offset = last - m_pos;
+      if (last < m_end || !fill()) {
+        break;
+      }
+      last = m_pos + offset;
+    }
+    auto const* first = m_buffer.data() + m_pos;
+    auto const* end = m_buffer.data() + last;
+    auto value = V{};
+    auto [ptr, ec] = std::from_chars(first, end, value);
+    if (ec != std::errc{} || ptr != end) {
+      throw std::runtime_error("Invalid value in front file: " + std::string(first, end));
+    }
+    m_pos = last;
+    return value;
+  }
+
+  std::ifstream m_is;
+  std::vector<char> m_buffer;
+  size_t m_pos = 0;
+  size_t m_end = 0;
+  size_t m_n = 0;
+  size_t m_m = 0;
+  H m_hv = {};
+  std::vector<T> m_reference;
+  std::vector<T> m_point;
+  size_t m_read = 0;
+  bool m_has_point = false;
+};
+
+// Writes the objective vectors of a set to a text front file, together
+// with the reference point and the hypervolume, which can be read with
+// hvdata_reader.
+struct write_hvdata_fn {
+  template <is_objective_vector_set S, is_objective_vector R, typename H>
+  requires std::ranges::forward_range<S> && std::is_arithmetic_v<H>
+  auto operator()(std::filesystem::path const& path, S const& set, R const& reference, H hv) const -> void {
+    auto const m = std::ranges::size(reference);
+    auto os = std::ofstream(path, std::ios::binary | std::ios::trunc);
+    if (!os) {
+      throw std::runtime_error("Can't open file " + path.string());
+    }
+
+    // Values are written to a buffer, which is written to the file when
+    // it may not have space for one more value
+    auto buffer = std::vector<char>(1 << 16);
+    auto pos = size_t{0};
+    auto flush = [&os, &buffer, &pos]() {
+      os.write(buffer.data(), static_cast<std::streamsize>(pos));
+      pos = 0;
+    };
+    auto put = [&buffer, &pos, &flush](auto value, char separator) {
+      if (buffer.size() - pos < 64) {
+        flush();
+      }
+      auto [ptr, ec] = std::to_chars(buffer.data() + pos, buffer.data() + buffer.size() - 1, value);
+      assert(ec == std::errc{});
+      *ptr = separator;
+      pos = static_cast<size_t>(ptr - buffer.data()) + 1;
+    };
+    auto put_vector = [&put](auto const& v) {
+      auto const size = std::ranges::size(v);
+      auto i = size_t{0};
+      for (auto const& x : v) {
+        put(x, ++i == size ? '\n' : ' ');
+      }
+    };
+
+    put(std::ranges::size(set), ' ');
+    put(m, '\n');
+    put(hv, '\n');
+    put_vector(reference);
+    for (auto const& s : set) {
+      auto const& ov = objective_vector(s);
+      if (std::ranges::size(ov) != m) {
+        throw std::invalid_argument("Objective vectors and reference point have different sizes");
+      }
+      put_vector(ov);
+    }
+    flush();
+    if (!os) {
+      throw std::runtime_error("Can't write file " + path.string());
+    }
+  }
+};
+
+inline constexpr write_hvdata_fn write_hvdata;
+
+}  // namespace mooutils
+
+#endif
@@ -6,7 +6,17 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <iterator>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#if !defined(MOOUTILS_DISABLE_SIMD) && __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define MOOUTILS_SIMD 1
+#endif
 
 namespace mooutils {
 
@@ -16,6 +26,127 @@ namespace mooutils {
 // TODO add dominated variants?
 // TODO add ordered set variants? would improved performance.
 
+// Objective vectors whose values are stored contiguously and have an
+// arithmetic type are compared with SIMD instructions (when
+// std::experimental::simd is available, unless MOOUTILS_DISABLE_SIMD
+// is defined). Instead of stopping at the first value that decides the
+// order, whole registers are compared at once and the resulting masks
+// are reduced, which avoids most of the (unpredictable) branches.
+template <typename V1, typename V2>
+concept is_contiguous_objective_vector_pair =
+    std::ranges::contiguous_range<V1> && std::ranges::contiguous_range<V2> &&
+    std::same_as<std::ranges::range_value_t<V1>, std::ranges::range_value_t<V2>> &&
+    std::is_arithmetic_v<std::ranges::range_value_t<V1>> && !std::same_as<std::ranges::range_value_t<V1>, bool>;
+
+#ifdef MOOUTILS_SIMD
+// Whether the values of type T can be compared lane-wise by the target,
+// which is the case for floating point and integer values of up to 32
+// bits, while 64-bit integer comparisons need SSE4.2 (pcmpgtq) on x86,
+// and are otherwise expanded piecewise, which is slower than the scalar
+// loop.
+template <typename T>
+inline constexpr bool has_native_simd_compare_v =
+    std::is_floating_point_v<T> || sizeof(T) <= 4
+#if defined(__SSE4_2__) || defined(__aarch64__)
+    || true
+#endif
+    ;
+#endif
+
+// Returns whether `pred1` holds for some pair of values of `v1` and
+// `v2`, and the same for `pred2`. The predicates take either two values
+// or two SIMD registers, and their results are accumulated without
+// branches, since objective vectors are usually short. The mask of
+// each register is reduced on its own, since OR-ing masks is not native
+// on every target (e.g., doubles without AVX) and would be expanded
+// piecewise.
+template <typename T, typename Pred1, typename Pred2>
+[[nodiscard]] constexpr auto any_of_values(T const* v1, T const* v2, size_t m, Pred1 pred1, Pred2 pred2)
+    -> std::pair<bool, bool> {
+  auto any1 = false;
+  auto any2 = false;
+  size_t i = 0;
+#ifdef MOOUTILS_SIMD
+  if constexpr (has_native_simd_compare_v<T>) {
+    using simd_type = std::experimental::native_simd<T>;
+    if (!std::is_constant_evaluated() && m >= simd_type::size()) {
+      for (; i + simd_type::size() <= m; i += simd_type::size()) {
+        auto const a = simd_type(v1 + i, std::experimental::element_aligned);
+        auto const b = simd_type(v2 + i, std::experimental::element_aligned);
+        any1 |= std::experimental::any_of(pred1(a, b));
+        any2 |= std::experimental::any_of(pred2(a, b));
+      }
+    }
+  }
+#endif
+  for (; i < m; ++i) {
+    any1 |= pred1(v1[i], v2[i]);
+    any2 |= pred2(v1[i], v2[i]);
+  }
+  return {any1, any2};
+}
+
+// Same as above, but with a single predicate.
+template <typename T, typename Pred>
+[[nodiscard]] constexpr auto any_of_values(T const* v1, T const* v2, size_t m, Pred pred) -> bool {
+  auto any = false;
+  size_t i = 0;
+#ifdef MOOUTILS_SIMD
+  if constexpr (has_native_simd_compare_v<T>) {
+    using simd_type = std::experimental::native_simd<T>;
+    if (!std::is_constant_evaluated() && m >= simd_type::size()) {
+      for (; i + simd_type::size() <= m; i += simd_type::size()) {
+        auto const a = simd_type(v1 + i, std::experimental::element_aligned);
+        auto const b = simd_type(v2 + i, std::experimental::element_aligned);
+        any |= std::experimental::any_of(pred(a, b));
+      }
+    }
+  }
+#endif
+  for (; i < m; ++i) {
+    any |= pred(v1[i], v2[i]);
+  }
+  return any;
+}
+
+// Objective vectors of which at least one has a number of values known
+// at compile time (see static_extent) are compared with a fully
+// unrolled loop, unless they are contiguous, in which case the SIMD
+// loop above is used with a constant number of values.
+template <typename V1, typename V2>
+concept is_static_objective_vector_pair =
+    static_extent_v<V1> != std::dynamic_extent || static_extent_v<V2> != std::dynamic_extent;
+
+// Same as the above, but on two objective vectors that are either
+// contiguous or of a static size.
+template <typename V1, typename V2, typename... Preds>
+  requires(is_static_objective_vector_pair<V1, V2> || is_contiguous_objective_vector_pair<V1, V2>)
+[[nodiscard]] constexpr auto any_of_values(V1 const& v1, V2 const& v2, Preds... preds) {
+  constexpr auto static_m = static_extent_v<V1> != std::dynamic_extent ? static_extent_v<V1> : static_extent_v<V2>;
+  assert(static_m == std::dynamic_extent || static_cast<size_t>(std::ranges::size(v1)) == static_m);
+  assert(static_m == std::dynamic_extent || static_cast<size_t>(std::ranges::size(v2)) == static_m);
+  if constexpr (is_contiguous_objective_vector_pair<V1, V2>) {
+    auto const m = static_m != std::dynamic_extent ? static_m : static_cast<size_t>(std::ranges::size(v1));
+    return any_of_values(std::ranges::data(v1), std::ranges::data(v2), m, preds...);
+  } else {
+    auto const first1 = std::ranges::begin(v1);
+    auto const first2 = std::ranges::begin(v2);
+    auto const any = [&]<size_t... I>(auto pred, std::index_sequence<I...>) -> bool {
+      return (false | ... | static_cast<bool>(pred(first1[I], first2[I])));
+    };
+    if constexpr (sizeof...(Preds) == 1) {
+      return (any(preds, std::make_index_sequence<static_m>{}), ...);
+    } else {
+      return std::pair<bool, bool>(any(preds, std::make_index_sequence<static_m>{})...);
+    }
+  }
+}
+
+inline constexpr auto less_values = [](auto const& a, auto const& b) { return a < b; };
+inline constexpr auto less_equal_values = [](auto const& a, auto const& b) { return a <= b; };
+inline constexpr auto greater_values = [](auto const& a, auto const& b) { return a > b; };
+inline constexpr auto not_equal_values = [](auto const& a, auto const& b) { return a != b; };
+
 struct equivalent_fn {
  public:
   template <is_or_has_objective_vector V1, is_or_has_objective_vector V2>
@@ -25,6 +156,10 @@ struct equivalent_fn {
     assert(std::ranges::size(ov1) > 0);
     assert(std::ranges::size(ov2) > 0);
     assert(std::ranges::size(ov1) == std::ranges::size(ov2));
+    if constexpr (is_static_objective_vector_pair<decltype(ov1), decltype(ov2)> ||
+                  is_contiguous_objective_vector_pair<decltype(ov1), decltype(ov2)>) {
+      return !any_of_values(ov1, ov2, not_equal_values);
+    }
     auto first1 = std::ranges::begin(ov1);
     auto last1 = std::ranges::end(ov1);
     auto first2 = std::ranges::begin(ov2);
@@ -113,6 +248,10 @@ struct weakly_dominates_fn {
     assert(std::ranges::size(ov1) > 0);
     assert(std::ranges::size(ov2) > 0);
     assert(std::ranges::size(ov1) == std::ranges::size(ov2));
+    if constexpr (is_static_objective_vector_pair<decltype(ov1), decltype(ov2)> ||
+                  is_contiguous_objective_vector_pair<decltype(ov1), decltype(ov2)>) {
+      return !any_of_values(ov1, ov2, less_values);
+    }
     auto first1 = std::ranges::begin(ov1);
     auto last1 = std::ranges::end(ov1);
     auto first2 = std::ranges::begin(ov2);
@@ -162,6 +301,11 @@ struct dominates_fn {
     assert(std::ranges::size(ov1) > 0);
     assert(std::ranges::size(ov2) > 0);
     assert(std::ranges::size(ov1) == std::ranges::size(ov2));
+    if constexpr (is_static_objective_vector_pair<decltype(ov1), decltype(ov2)> ||
+                  is_contiguous_objective_vector_pair<decltype(ov1), decltype(ov2)>) {
+      auto const [less, greater] = any_of_values(ov1, ov2, less_values, greater_values);
+      return !less && greater;
+    }
     auto first1 = std::ranges::begin(ov1);
     auto last1 = std::ranges::end(ov1);
     auto first2 = std::ranges::begin(ov2);
@@ -229,6 +373,10 @@ struct strictly_dominates_fn {
     assert(std::ranges::size(ov1) > 0);
     assert(std::ranges::size(ov2) > 0);
     assert(std::ranges::size(ov1) == std::ranges::size(ov2));
+    if constexpr (is_static_objective_vector_pair<decltype(ov1), decltype(ov2)> ||
+                  is_contiguous_objective_vector_pair<decltype(ov1), decltype(ov2)>) {
+      return !any_of_values(ov1, ov2, less_equal_values);
+    }
     auto first1 = std::ranges::begin(ov1);
     auto last1 = std::ranges::end(ov1);
     auto first2 = std::ranges::begin(ov2);
@@ -278,6 +426,11 @@ struct incomparable_fn {
     assert(std::ranges::size(ov1) > 0);
     assert(std::ranges::size(ov2) > 0);
     assert(std::ranges::size(ov1) == std::ranges::size(ov2));
+    if constexpr (is_static_objective_vector_pair<decltype(ov1), decltype(ov2)> ||
+                  is_contiguous_objective_vector_pair<decltype(ov1), decltype(ov2)>) {
+      auto const [less, greater] = any_of_values(ov1, ov2, less_values, greater_values);
+      return less && greater;
+    }
     auto first1 = std::ranges::begin(ov1);
     auto last1 = std::ranges::end(ov1);
     auto first2 = std::ranges::begin(ov2);
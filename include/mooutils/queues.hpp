@@ -1,10 +1,22 @@
 #ifndef MOOUTILS_QUEUES_HPP_
 #define MOOUTILS_QUEUES_HPP_
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <random>
+#include <thread>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace mooutils {
@@ -112,20 +124,56 @@ class lifo_queue : public base_queue<lifo_queue<Solution, Container>, Solution,
   }
 };
 
+// Queue that pops a solution uniformly at random. Any
+// UniformRandomBitGenerator can be used, such as xoshiro256plusplus
+// (see random.hpp), which is faster than the standard ones and has
+// reproducible streams for each thread.
 template <typename Solution, typename Rng, typename Container = std::vector<Solution>>
 class random_queue : public base_queue<random_queue<Solution, Rng, Container>, Solution, Container> {
  public:
   using rng_type = Rng;
 
+  // The generator is the first argument, and the remaining ones are
+  // forwarded to the container.
   template <typename... Args>
-  explicit random_queue(Args&&... args, Rng&& prng)
+  explicit random_queue(Rng prng, Args&&... args)
       : base_class_type(std::forward<Args>(args)...)
       , rng(std::move(prng)) {}
 
+  // Pops min(k, size()) solutions at once, into `out`, which are the
+  // same as the ones popped by as many calls to pop(). The indices are
+  // drawn with a partial Fisher-Yates shuffle, that swaps each one to
+  // the back, and the solutions are then moved out in a single pass.
+  template <std::output_iterator<Solution> OutputIt>
+  constexpr auto pop_n(size_t k, OutputIt out) -> OutputIt {
+    auto const n = this->c.size();
+    k = std::min(k, n);
+    for (size_type i = 0; i < k; ++i) {
+      auto const last = n - 1 - i;
+      auto const ind = dist(rng, typename dist_type::param_type(0, last));
+      if (ind != last) {
+        std::ranges::swap(this->c[ind], this->c[last]);
+      }
+    }
+    for (size_type i = 0; i < k; ++i) {
+      *out = std::move(this->c[n - 1 - i]);
+      ++out;
+    }
+    this->c.erase(this->c.end() - static_cast<std::ptrdiff_t>(k), this->c.end());
+    return out;
+  }
+
+  // Reseeds the generator, e.g., to repeat a run.
+  template <typename... Args>
+  constexpr auto seed(Args&&... args) -> void {
+    rng.seed(std::forward<Args>(args)...);
+  }
+
  private:
   using base_class_type = base_queue<random_queue<Solution, Rng, Container>, Solution, Container>;
   using typename base_class_type::size_type;
   using typename base_class_type::value_type;
+  using dist_type = std::uniform_int_distribution<size_type>;
 
   friend base_class_type;
 
@@ -136,11 +184,10 @@ class random_queue : public base_queue<random_queue<Solution, Rng, Container>, S
   }
 
   constexpr auto pop_impl() -> value_type {
-    auto size_minus_1 = this->c.size() - 1;
-    auto runif = std::uniform_int_distribution<size_type>(0, size_minus_1);
-    auto ind = runif(this->rng);
+    auto const last = this->c.size() - 1;
+    auto const ind = dist(rng, typename dist_type::param_type(0, last));
     auto ret = std::move(this->c[ind]);
-    if (ind != size_minus_1) {
+    if (ind != last) {
       this->c[ind] = std::move(this->c.back());
     }
     this->c.pop_back();
@@ -148,6 +195,745 @@ class random_queue : public base_queue<random_queue<Solution, Rng, Container>, S
   }
 
   rng_type rng;
+  dist_type dist;
+};
+
+// Solution in a priority_queue, with its key and the index of its
+// handle.
+template <typename Solution, typename KeyValue>
+struct priority_queue_entry {
+  Solution value;
+  KeyValue key;
+  size_t handle;
+};
+
+// Handle to a solution in a priority_queue. Indices are reused by later
+// solutions, while the generation of an index is incremented each time
+// its solution leaves the queue, such that a stale handle is detected.
+struct priority_queue_handle {
+  size_t index;
+  size_t generation;
+
+  [[nodiscard]] friend constexpr auto operator==(priority_queue_handle const&, priority_queue_handle const&)
+      -> bool = default;
+};
+
+// Queue that pops the solution with the largest key (w.r.t. Compare),
+// where the key of a solution is given by a Key functor when it is
+// pushed, such as its hypervolume contribution to an archive, or its
+// crowding distance. The solutions are kept in a d-ary heap in a flat
+// vector (a larger Arity makes the heap shallower, at the cost of more
+// comparisons when sifting down).
+//
+// Pushing a solution returns a handle, which stays valid until the
+// solution is popped or erased, and allows to update its key, when the
+// archive changes, or to erase it, in O(log n) time. Afterwards,
+// contains() is false for the handle.
+template <typename Solution, typename Key, typename Compare = std::less<>, size_t Arity = 4,
+          typename KeyValue = std::remove_cvref_t<std::invoke_result_t<Key&, Solution const&>>>
+class priority_queue
+    : public base_queue<priority_queue<Solution, Key, Compare, Arity, KeyValue>, Solution,
+                        std::vector<priority_queue_entry<Solution, KeyValue>>> {
+  static_assert(Arity >= 2);
+
+ public:
+  using key_type = KeyValue;
+  using handle_type = priority_queue_handle;
+
+  explicit priority_queue(Key key = Key(), Compare compare = Compare())
+      : base_class_type()
+      , m_key(std::move(key))
+      , m_compare(std::move(compare)) {}
+
+  [[nodiscard]] auto top() const -> Solution const& {
+    assert(!this->c.empty());
+    return this->c.front().value;
+  }
+
+  [[nodiscard]] auto top_key() const -> key_type const& {
+    assert(!this->c.empty());
+    return this->c.front().key;
+  }
+
+  [[nodiscard]] auto contains(handle_type h) const -> bool {
+    return h.index < m_slots.size() && m_slots[h.index].position != npos &&
+           m_slots[h.index].generation == h.generation;
+  }
+
+  [[nodiscard]] auto operator[](handle_type h) const -> Solution const& {
+    assert(contains(h));
+    return this->c[m_slots[h.index].position].value;
+  }
+
+  [[nodiscard]] auto key(handle_type h) const -> key_type const& {
+    assert(contains(h));
+    return this->c[m_slots[h.index].position].key;
+  }
+
+  auto update_key(handle_type h, key_type key) -> void {
+    assert(contains(h));
+    auto const i = m_slots[h.index].position;
+    auto const increased = m_compare(this->c[i].key, key);
+    this->c[i].key = std::move(key);
+    if (increased) {
+      sift_up(i);
+    } else {
+      sift_down(i);
+    }
+  }
+
+  // Recomputes the key of a solution with the Key functor.
+  auto update_key(handle_type h) -> void {
+    assert(contains(h));
+    update_key(h, m_key(std::as_const(this->c[m_slots[h.index].position].value)));
+  }
+
+  // Recomputes the keys of all solutions, and rebuilds the heap in
+  // O(n) time, which is cheaper than updating more than a few keys.
+  auto update_keys() -> void {
+    for (auto& e : this->c) {
+      e.key = m_key(std::as_const(e.value));
+    }
+    if (this->c.size() > 1) {
+      for (auto i = (this->c.size() - 2) / Arity + 1; i-- > 0;) {
+        sift_down(i);
+      }
+    }
+  }
+
+  // Removes a solution and returns it.
+  auto erase(handle_type h) -> Solution {
+    assert(contains(h));
+    return erase_at(m_slots[h.index].position);
+  }
+
+ private:
+  using entry_type = priority_queue_entry<Solution, KeyValue>;
+  using base_class_type = base_queue<priority_queue<Solution, Key, Compare, Arity, KeyValue>, Solution,
+                                     std::vector<entry_type>>;
+  using typename base_class_type::value_type;
+
+  friend base_class_type;
+
+  static constexpr auto npos = std::numeric_limits<size_t>::max();
+
+  // Position in the heap of the solution of a handle index (npos if the
+  // index is free), and the current generation of the index
+  struct slot {
+    size_t position;
+    size_t generation;
+  };
+
+  template <typename S>
+  auto push_impl(S&& s) -> handle_type {
+    auto key = m_key(std::as_const(s));
+    auto h = m_slots.size();
+    if (m_free.empty()) {
+      m_slots.push_back(slot{npos, 0});
+    } else {
+      h = m_free.back();
+      m_free.pop_back();
+    }
+    this->c.push_back(entry_type{std::forward<S>(s), std::move(key), h});
+    m_slots[h].position = this->c.size() - 1;
+    sift_up(this->c.size() - 1);
+    return handle_type{h, m_slots[h].generation};
+  }
+
+  auto pop_impl() -> value_type {
+    return erase_at(0);
+  }
+
+  auto erase_at(size_t i) -> Solution {
+    auto res = std::move(this->c[i].value);
+    auto const h = this->c[i].handle;
+    m_slots[h].position = npos;
+    ++m_slots[h].generation;
+    m_free.push_back(h);
+    if (i + 1 == this->c.size()) {
+      this->c.pop_back();
+      return res;
+    }
+    move_to(i, std::move(this->c.back()));
+    this->c.pop_back();
+    if (i > 0 && m_compare(this->c[(i - 1) / Arity].key, this->c[i].key)) {
+      sift_up(i);
+    } else {
+      sift_down(i);
+    }
+    return res;
+  }
+
+  auto move_to(size_t i, entry_type&& e) -> void {
+    this->c[i] = std::move(e);
+    m_slots[this->c[i].handle].position = i;
+  }
+
+  // The entry at position i is moved up (or down) through a hole,
+  // instead of being swapped at each level.
+  auto sift_up(size_t i) -> void {
+    auto e = std::move(this->c[i]);
+    while (i > 0) {
+      auto const parent = (i - 1) / Arity;
+      if (!m_compare(this->c[parent].key, e.key)) {
+        break;
+      }
+      move_to(i, std::move(this->c[parent]));
+      i = parent;
+    }
+    move_to(i, std::move(e));
+  }
+
+  auto sift_down(size_t i) -> void {
+    auto const n = this->c.size();
+    auto e = std::move(this->c[i]);
+    for (;;) {
+      auto const first = Arity * i + 1;
+      if (first >= n) {
+        break;
+      }
+      auto best = first;
+      for (auto j = first + 1; j < std::min(first + Arity, n); ++j) {
+        if (m_compare(this->c[best].key, this->c[j].key)) {
+          best = j;
+        }
+      }
+      if (!m_compare(e.key, this->c[best].key)) {
+        break;
+      }
+      move_to(i, std::move(this->c[best]));
+      i = best;
+    }
+    move_to(i, std::move(e));
+  }
+
+  Key m_key;
+  Compare m_compare;
+  std::vector<slot> m_slots;
+  std::vector<size_t> m_free;
+};
+
+// Queues that many threads can push to and pop from at once, such as
+// the solutions to explore in a parallel Pareto local search. They
+// have the same interface as the queues above, where push() and pop()
+// wait (yielding the thread) while the queue is full or empty,
+// respectively, and try_push() and try_pop() return instead. The
+// capacity is fixed on construction, and size() is only exact when
+// no thread is modifying the queue.
+
+// Bounded multi-producer multi-consumer FIFO queue, based on a ring
+// buffer where each slot has a sequence number that tells whether it
+// is ready to be written or read in the current lap, as in D. Vyukov's
+// "Bounded MPMC queue". A push or pop only contends on a single atomic
+// position, and never locks.
+template <typename Solution>
+class concurrent_fifo_queue {
+ public:
+  using value_type = Solution;
+  using size_type = size_t;
+
+  // The capacity is rounded up to a power of two.
+  explicit concurrent_fifo_queue(size_type capacity)
+      : m_mask(std::bit_ceil(std::max(capacity, size_type{2})) - 1)
+      , m_slots(std::make_unique<slot[]>(m_mask + 1)) {
+    for (size_type i = 0; i <= m_mask; ++i) {
+      m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  concurrent_fifo_queue(concurrent_fifo_queue const&) = delete;
+  auto operator=(concurrent_fifo_queue const&) -> concurrent_fifo_queue& = delete;
+
+  auto push(value_type const& value) -> void {
+    while (!try_push(value)) {
+      std::this_thread::yield();
+    }
+  }
+
+  auto push(value_type&& value) -> void {
+    while (!try_push(std::move(value))) {
+      std::this_thread::yield();
+    }
+  }
+
+  auto pop() -> value_type {
+    for (;;) {
+      if (auto res = try_pop()) {
+        return std::move(*res);
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  // Returns false, without moving from `value`, if the queue is full.
+  template <typename S>
+  auto try_push(S&& value) -> bool {
+    auto pos = m_enqueue.load(std::memory_order_relaxed);
+    slot* s;
+    for (;;) {
+      s = &m_slots[pos & m_mask];
+      auto const seq = s->sequence.load(std::memory_order_acquire);
+      auto const diff = static_cast<std::ptrdiff_t>(seq - pos);
+      if (diff == 0) {
+        if (m_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = m_enqueue.load(std::memory_order_relaxed);
+      }
+    }
+    s->value.emplace(std::forward<S>(value));
+    s->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  auto try_pop() -> std::optional<value_type> {
+    auto pos = m_dequeue.load(std::memory_order_relaxed);
+    slot* s;
+    for (;;) {
+      s = &m_slots[pos & m_mask];
+      auto const seq = s->sequence.load(std::memory_order_acquire);
+      auto const diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+      if (diff == 0) {
+        if (m_dequeue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return std::nullopt;
+      } else {
+        pos = m_dequeue.load(std::memory_order_relaxed);
+      }
+    }
+    auto res = std::optional<value_type>(std::move(*s->value));
+    s->value.reset();
+    s->sequence.store(pos + m_mask + 1, std::memory_order_release);
+    return res;
+  }
+
+  [[nodiscard]] auto empty() const -> bool {
+    return size() == 0;
+  }
+
+  [[nodiscard]] auto size() const -> size_type {
+    auto const dequeue = m_dequeue.load(std::memory_order_acquire);
+    auto const enqueue = m_enqueue.load(std::memory_order_acquire);
+    return enqueue > dequeue ? enqueue - dequeue : 0;
+  }
+
+  [[nodiscard]] auto capacity() const -> size_type {
+    return m_mask + 1;
+  }
+
+ private:
+  struct slot {
+    std::atomic<size_type> sequence;
+    std::optional<value_type> value;
+  };
+
+  size_type m_mask;
+  std::unique_ptr<slot[]> m_slots;
+  // On different (typical) cache lines, such that producers and
+  // consumers do not contend
+  alignas(64) std::atomic<size_type> m_enqueue = 0;
+  alignas(64) std::atomic<size_type> m_dequeue = 0;
+};
+
+// Bounded multi-producer multi-consumer LIFO queue, as a Treiber stack.
+// The nodes are preallocated and, when popped, go back to a free list
+// (another Treiber stack), so they are never deallocated while other
+// threads may read them. The top of each stack is a 32 bit node index
+// together with a 32 bit tag that is incremented on every update, such
+// that a compare-and-swap fails if the top was popped and pushed back
+// in between (the ABA problem), with a single word atomic.
+template <typename Solution>
+class concurrent_lifo_queue {
+ public:
+  using value_type = Solution;
+  using size_type = size_t;
+
+  explicit concurrent_lifo_queue(size_type capacity)
+      : m_nodes(std::make_unique<node[]>(capacity)) {
+    assert(capacity < npos);
+    for (size_type i = 0; i < capacity; ++i) {
+      push_node(m_free, static_cast<uint32_t>(i));
+    }
+  }
+
+  concurrent_lifo_queue(concurrent_lifo_queue const&) = delete;
+  auto operator=(concurrent_lifo_queue const&) -> concurrent_lifo_queue& = delete;
+
+  auto push(value_type const& value) -> void {
+    while (!try_push(value)) {
+      std::this_thread::yield();
+    }
+  }
+
+  auto push(value_type&& value) -> void {
+    while (!try_push(std::move(value))) {
+      std::this_thread::yield();
+    }
+  }
+
+  auto pop() -> value_type {
+    for (;;) {
+      if (auto res = try_pop()) {
+        return std::move(*res);
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  // Returns false, without moving from `value`, if the queue is full.
+  template <typename S>
+  auto try_push(S&& value) -> bool {
+    auto const i = pop_node(m_free);
+    if (i == npos) {
+      return false;
+    }
+    m_nodes[i].value.emplace(std::forward<S>(value));
+    // Before publishing the node, such that the size is never negative
+    m_size.fetch_add(1, std::memory_order_relaxed);
+    push_node(m_top, i);
+    return true;
+  }
+
+  auto try_pop() -> std::optional<value_type> {
+    auto const i = pop_node(m_top);
+    if (i == npos) {
+      return std::nullopt;
+    }
+    m_size.fetch_sub(1, std::memory_order_relaxed);
+    auto res = std::optional<value_type>(std::move(*m_nodes[i].value));
+    m_nodes[i].value.reset();
+    push_node(m_free, i);
+    return res;
+  }
+
+  [[nodiscard]] auto empty() const -> bool {
+    return size() == 0;
+  }
+
+  [[nodiscard]] auto size() const -> size_type {
+    return m_size.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint32_t npos = UINT32_MAX;
+
+  struct node {
+    std::atomic<uint32_t> next = npos;
+    std::optional<value_type> value;
+  };
+
+  // Tagged index of the top node of a stack
+  static constexpr auto make_top(uint64_t top, uint32_t i) -> uint64_t {
+    return ((top >> 32) + 1) << 32 | i;
+  }
+
+  auto push_node(std::atomic<uint64_t>& stack, uint32_t i) -> void {
+    auto top = stack.load(std::memory_order_relaxed);
+    do {
+      m_nodes[i].next.store(static_cast<uint32_t>(top), std::memory_order_relaxed);
+    } while (!stack.compare_exchange_weak(top, make_top(top, i), std::memory_order_release,
+                                          std::memory_order_relaxed));
+  }
+
+  // The next index of the top node may be stale if another thread pops
+  // it first, in which case the tag has changed and the swap fails.
+  auto pop_node(std::atomic<uint64_t>& stack) -> uint32_t {
+    auto top = stack.load(std::memory_order_acquire);
+    for (;;) {
+      auto const i = static_cast<uint32_t>(top);
+      if (i == npos) {
+        return npos;
+      }
+      auto const next = m_nodes[i].next.load(std::memory_order_relaxed);
+      if (stack.compare_exchange_weak(top, make_top(top, next), std::memory_order_acquire,
+                                      std::memory_order_acquire)) {
+        return i;
+      }
+    }
+  }
+
+  std::unique_ptr<node[]> m_nodes;
+  alignas(64) std::atomic<uint64_t> m_top = npos;
+  alignas(64) std::atomic<uint64_t> m_free = npos;
+  alignas(64) std::atomic<size_type> m_size = 0;
+};
+
+// Work-stealing deque of Chase and Lev, with the memory orders of "N.
+// M. Lê, A. Pop, A. Cohen, and F. Zappa Nardelli, "Correct and
+// efficient work-stealing for weak memory models," in Proceedings of
+// the 18th ACM SIGPLAN Symposium on Principles and Practice of Parallel
+// Programming, pp. 69-80, 2013."
+//
+// Only the owner thread may push and pop at the back, while any thread
+// may steal from the front. The ring buffer grows as needed, and the
+// previous ones are kept until destruction, since thieves may still be
+// reading them. The slots hold pointers to heap allocated values, such
+// that a thief reading a slot that is concurrently overwritten does not
+// race on the value itself.
+template <typename T>
+class chase_lev_deque {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  explicit chase_lev_deque(size_type capacity = 64) {
+    m_rings.push_back(std::make_unique<ring>(std::bit_ceil(std::max(capacity, size_type{2}))));
+    m_ring.store(m_rings.back().get(), std::memory_order_relaxed);
+  }
+
+  chase_lev_deque(chase_lev_deque const&) = delete;
+  auto operator=(chase_lev_deque const&) -> chase_lev_deque& = delete;
+
+  ~chase_lev_deque() {
+    auto* r = m_ring.load(std::memory_order_relaxed);
+    auto const b = m_bottom.load(std::memory_order_relaxed);
+    for (auto t = m_top.load(std::memory_order_relaxed); t < b; ++t) {
+      delete r->get(t);
+    }
+  }
+
+  // Owner only
+  template <typename S>
+  auto push_back(S&& value) -> void {
+    auto const b = m_bottom.load(std::memory_order_relaxed);
+    auto const t = m_top.load(std::memory_order_acquire);
+    auto* r = m_ring.load(std::memory_order_relaxed);
+    if (b - t > static_cast<int64_t>(r->mask)) {
+      m_rings.push_back(r->grow(t, b));
+      r = m_rings.back().get();
+      m_ring.store(r, std::memory_order_release);
+    }
+    r->put(b, new value_type(std::forward<S>(value)));
+    m_bottom.store(b + 1, std::memory_order_release);
+  }
+
+  // Owner only
+  auto pop_back() -> std::optional<value_type> {
+    auto const b = m_bottom.load(std::memory_order_relaxed) - 1;
+    auto* r = m_ring.load(std::memory_order_relaxed);
+    m_bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto t = m_top.load(std::memory_order_relaxed);
+    if (t > b) {
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+    auto* p = r->get(b);
+    if (t == b) {
+      // Last value, race against the thieves
+      auto const won = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+      if (!won) {
+        return std::nullopt;
+      }
+    }
+    return take(p);
+  }
+
+  // Returns nothing if the deque is empty or another thread took the
+  // front value first.
+  auto steal() -> std::optional<value_type> {
+    auto t = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto const b = m_bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+      return std::nullopt;
+    }
+    auto* p = m_ring.load(std::memory_order_acquire)->get(t);
+    if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return std::nullopt;
+    }
+    return take(p);
+  }
+
+  [[nodiscard]] auto empty() const -> bool {
+    return size() == 0;
+  }
+
+  [[nodiscard]] auto size() const -> size_type {
+    auto const t = m_top.load(std::memory_order_acquire);
+    auto const b = m_bottom.load(std::memory_order_acquire);
+    return b > t ? static_cast<size_type>(b - t) : 0;
+  }
+
+ private:
+  struct ring {
+    explicit ring(size_type capacity)
+        : mask(static_cast<int64_t>(capacity) - 1)
+        , slots(std::make_unique<std::atomic<value_type*>[]>(capacity)) {}
+
+    [[nodiscard]] auto get(int64_t i) const -> value_type* {
+      return slots[static_cast<size_type>(i & mask)].load(std::memory_order_relaxed);
+    }
+
+    auto put(int64_t i, value_type* p) -> void {
+      slots[static_cast<size_type>(i & mask)].store(p, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto grow(int64_t t, int64_t b) const -> std::unique_ptr<ring> {
+      auto res = std::make_unique<ring>(2 * static_cast<size_type>(mask + 1));
+      for (auto i = t; i < b; ++i) {
+        res->put(i, get(i));
+      }
+      return res;
+    }
+
+    int64_t mask;
+    std::unique_ptr<std::atomic<value_type*>[]> slots;
+  };
+
+  static auto take(value_type* p) -> std::optional<value_type> {
+    auto owned = std::unique_ptr<value_type>(p);
+    return std::optional<value_type>(std::move(*owned));
+  }
+
+  alignas(64) std::atomic<int64_t> m_top = 0;
+  alignas(64) std::atomic<int64_t> m_bottom = 0;
+  std::atomic<ring*> m_ring;
+  std::vector<std::unique_ptr<ring>> m_rings;
+};
+
+// Queue of a worker in a work_stealing_pool. The owner pushes and pops
+// solutions as in a lifo_queue, which explores the neighbours of the
+// last solution first, while other workers steal the oldest ones.
+// Since thieves may take the last solution at any time, the owner
+// should use try_pop() instead of checking empty() before pop().
+template <typename Solution, typename Container = chase_lev_deque<Solution>>
+class work_stealing_queue : public base_queue<work_stealing_queue<Solution, Container>, Solution, Container> {
+ public:
+  template <typename... Args>
+  explicit work_stealing_queue(Args&&... args)
+      : base_class_type(std::forward<Args>(args)...) {}
+
+  auto try_pop() -> std::optional<Solution> {
+    return this->c.pop_back();
+  }
+
+  auto steal() -> std::optional<Solution> {
+    return this->c.steal();
+  }
+
+ private:
+  using base_class_type = base_queue<work_stealing_queue<Solution, Container>, Solution, Container>;
+  using typename base_class_type::value_type;
+
+  friend base_class_type;
+
+  template <typename S>
+  constexpr auto push_impl(S&& s) {
+    this->c.push_back(std::forward<S>(s));
+  }
+
+  constexpr auto pop_impl() -> value_type {
+    auto res = this->c.pop_back();
+    assert(res.has_value());
+    return std::move(*res);
+  }
+};
+
+// A work_stealing_queue for each of `n` workers, with termination
+// detection. Worker w pushes the solutions to explore into queue(w) and
+// takes the next one with next(w), which pops from its own queue first
+// and otherwise steals from the others, as in
+//
+//   while (auto s = pool.next(w)) {
+//     for (auto& neighbour : explore(*s)) {
+//       pool.queue(w).push(neighbour);
+//     }
+//   }
+//
+// A worker is active from the start until next() fails to find a
+// solution, and again while it tries to steal one. Only active workers
+// hold or push solutions, and a worker only becomes idle with its own
+// queue empty, so when no worker is active every queue is empty and
+// next() returns nothing to all of them. The initial solutions should
+// be pushed before the workers start.
+template <typename Solution, typename Container = chase_lev_deque<Solution>>
+class work_stealing_pool {
+ public:
+  using value_type = Solution;
+  using queue_type = work_stealing_queue<Solution, Container>;
+  using size_type = size_t;
+
+  explicit work_stealing_pool(size_type n)
+      : m_queues(std::make_unique<queue_type[]>(n))
+      , m_n(n)
+      , m_active(n) {
+    assert(n > 0);
+  }
+
+  [[nodiscard]] auto queue(size_type w) -> queue_type& {
+    assert(w < m_n);
+    return m_queues[w];
+  }
+
+  [[nodiscard]] auto workers() const -> size_type {
+    return m_n;
+  }
+
+  // Next solution for worker w, or nothing once every queue is empty
+  // and no worker is active, after which w must not call it again.
+  auto next(size_type w) -> std::optional<value_type> {
+    assert(w < m_n);
+    for (;;) {
+      if (auto s = take(w)) {
+        return s;
+      }
+      if (m_active.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        m_done.store(true, std::memory_order_release);
+        return std::nullopt;
+      }
+      while (!any_nonempty()) {
+        if (m_done.load(std::memory_order_acquire)) {
+          return std::nullopt;
+        }
+        std::this_thread::yield();
+      }
+      m_active.fetch_add(1, std::memory_order_acq_rel);
+    }
+  }
+
+  // Total number of solutions in the queues, which is only exact when
+  // no worker is modifying them.
+  [[nodiscard]] auto size() -> size_type {
+    auto res = size_type{0};
+    for (size_type i = 0; i < m_n; ++i) {
+      res += m_queues[i].size();
+    }
+    return res;
+  }
+
+ private:
+  auto take(size_type w) -> std::optional<value_type> {
+    if (auto s = m_queues[w].try_pop()) {
+      return s;
+    }
+    for (size_type k = 1; k < m_n; ++k) {
+      if (auto s = m_queues[(w + k) % m_n].steal()) {
+        return s;
+      }
+    }
+    return std::nullopt;
+  }
+
+  auto any_nonempty() -> bool {
+    for (size_type i = 0; i < m_n; ++i) {
+      if (!m_queues[i].empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::unique_ptr<queue_type[]> m_queues;
+  size_type m_n;
+  alignas(64) std::atomic<size_type> m_active;
+  std::atomic<bool> m_done = false;
 };
 
 }  // namespace mooutils
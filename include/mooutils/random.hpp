@@ -0,0 +1,107 @@
+#ifndef MOOUTILS_RANDOM_HPP_
+#define MOOUTILS_RANDOM_HPP_
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace mooutils {
+
+// The xoshiro256++ pseudo-random number generator of "D. Blackman and
+// S. Vigna, "Scrambled linear pseudorandom number generators," ACM
+// Transactions on Mathematical Software, vol. 47, no. 4, pp. 1-32,
+// 2021." It is a UniformRandomBitGenerator with a 256 bit state, that
+// is much smaller and faster than std::mt19937_64, and can be reseeded
+// without allocating.
+//
+// The sequence is split into 2^128 non-overlapping streams of length
+// 2^128, with jump(), such that each thread can have its own
+// reproducible stream from the same seed, e.g., with
+// xoshiro256plusplus(seed, thread_index).
+class xoshiro256plusplus {
+ public:
+  using result_type = uint64_t;
+
+  static constexpr result_type default_seed = 42;
+
+  constexpr explicit xoshiro256plusplus(result_type seed = default_seed, uint64_t stream = 0) {
+    this->seed(seed, stream);
+  }
+
+  constexpr explicit xoshiro256plusplus(std::array<uint64_t, 4> const& state)
+      : m_state(state) {}
+
+  // The state is filled with the splitmix64 generator, as recommended
+  // by the authors, which never gives the all zero state.
+  constexpr auto seed(result_type seed = default_seed, uint64_t stream = 0) -> void {
+    for (auto& s : m_state) {
+      seed += 0x9e3779b97f4a7c15;
+      auto z = seed;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+      s = z ^ (z >> 31);
+    }
+    for (uint64_t i = 0; i < stream; ++i) {
+      jump();
+    }
+  }
+
+  [[nodiscard]] static constexpr auto min() -> result_type {
+    return std::numeric_limits<result_type>::min();
+  }
+
+  [[nodiscard]] static constexpr auto max() -> result_type {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  constexpr auto operator()() -> result_type {
+    auto const res = std::rotl(m_state[0] + m_state[3], 23) + m_state[0];
+    auto const t = m_state[1] << 17;
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+    m_state[2] ^= t;
+    m_state[3] = std::rotl(m_state[3], 45);
+    return res;
+  }
+
+  constexpr auto discard(unsigned long long n) -> void {
+    for (; n > 0; --n) {
+      operator()();
+    }
+  }
+
+  // Advances the state by 2^128 values, i.e., to the next stream.
+  constexpr auto jump() -> void {
+    constexpr auto polynomial = std::array<uint64_t, 4>{0x180ec6d33cfd0aba, 0xd5a61266f0c9392c,  // noformat
+                                                        0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+    auto state = std::array<uint64_t, 4>{0, 0, 0, 0};
+    for (auto p : polynomial) {
+      for (int b = 0; b < 64; ++b) {
+        if ((p >> b) & 1) {
+          for (size_t i = 0; i < 4; ++i) {
+            state[i] ^= m_state[i];
+          }
+        }
+        operator()();
+      }
+    }
+    m_state = state;
+  }
+
+  [[nodiscard]] constexpr auto state() const -> std::array<uint64_t, 4> const& {
+    return m_state;
+  }
+
+  friend constexpr auto operator==(xoshiro256plusplus const& lhs, xoshiro256plusplus const& rhs) -> bool = default;
+
+ private:
+  std::array<uint64_t, 4> m_state = {};
+};
+
+}  // namespace mooutils
+
+#endif
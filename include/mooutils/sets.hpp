@@ -5,16 +5,309 @@
 #include "orders.hpp"
 #include "solution.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <ranges>
 #include <set>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace mooutils {
 
+// Indices, in increasing order, of the solutions in a range that are
+// not dominated by any other solution in it. Equivalent solutions are
+// all kept.
+//
+// The objective vectors are first copied into a contiguous buffer, with
+// the sum of the objectives of each one. The solutions strictly
+// dominated by the one with the largest sum (which is never dominated)
+// are discarded, which is cheap and removes most of the solutions of a
+// random population. The remaining ones are sorted in decreasing
+// lexicographical order, such that a solution can only be dominated by
+// the ones before it. For two objectives, a single sweep over them
+// keeps the ones that improve on the largest second objective so far,
+// in O(n log n) time. Otherwise, the divide and conquer algorithm of
+// "H. T. Kung, F. Luccio, and F. P. Preparata, "On Finding the Maxima
+// of a Set of Vectors," in Journal of the ACM, vol. 22, no. 4, pp.
+// 469-476, 1975" is used, in O(n log^(m-2) n) time, on one solution of
+// each group of equivalent ones. It computes the front of each half,
+// and then removes the solutions of the second front that are
+// dominated by the first one, with the recursive filter step of the
+// paper (see filter below).
+struct nondominated_filter_fn {
+  template <std::ranges::random_access_range R>
+  requires is_objective_vector_set<R>
+  [[nodiscard]] constexpr auto operator()(R const& range) const -> std::vector<size_t> {
+    auto const n = static_cast<size_t>(std::ranges::size(range));
+    if (n == 0) {
+      return {};
+    }
+
+    using value_type = objective_value_t<R const>;
+    auto const m = static_cast<size_t>(std::ranges::size(objective_vector(*std::ranges::begin(range))));
+    auto values = std::vector<value_type>();
+    values.reserve(n * m);
+    auto sums = std::vector<double>();
+    sums.reserve(n);
+    for (auto const& v : objective_vectors(range)) {
+      auto sum = 0.0;
+      for (auto x : v) {
+        values.push_back(x);
+        sum += static_cast<double>(x);
+      }
+      sums.push_back(sum);
+    }
+    auto const w = workspace<value_type>{values, sums, m};
+
+    auto const best = static_cast<size_t>(std::ranges::max_element(sums) - sums.begin());
+    auto order = std::vector<size_t>();
+    order.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      if (!w.dominates(best, i)) {
+        order.push_back(i);
+      }
+    }
+    std::ranges::stable_sort(order, [&w](auto i, auto j) { return w.lexicographically_greater(i, j); });
+
+    auto res = std::vector<size_t>();
+    if (m == 2) {
+      // Equivalent solutions are consecutive, and are all kept if the
+      // first one is
+      for (auto i : order) {
+        if (res.empty() || w.value(i, 1) > w.value(res.back(), 1) || w.equivalent(i, res.back())) {
+          res.push_back(i);
+        }
+      }
+    } else {
+      // Equivalent solutions are consecutive, and only the first one of
+      // each group is given to kung, such that the solutions that it
+      // compares are distinct
+      auto representatives = std::vector<size_t>();
+      for (size_t i = 0; i < order.size(); ++i) {
+        if (i == 0 || !w.equivalent(order[i], order[i - 1])) {
+          representatives.push_back(order[i]);
+        }
+      }
+      auto kept = std::vector<bool>(n, false);
+      for (auto i : kung(representatives, w)) {
+        kept[i] = true;
+      }
+      auto representative = size_t{0};
+      for (size_t i = 0; i < order.size(); ++i) {
+        if (i == 0 || !w.equivalent(order[i], order[i - 1])) {
+          representative = order[i];
+        }
+        if (kept[representative]) {
+          res.push_back(order[i]);
+        }
+      }
+    }
+    std::ranges::sort(res);
+    return res;
+  }
+
+ private:
+  template <typename T>
+  struct workspace {
+    std::vector<T> const& values;
+    std::vector<double> const& sums;
+    size_t m;
+
+    [[nodiscard]] constexpr auto value(size_t i, size_t k) const -> T const& {
+      return values[i * m + k];
+    }
+
+    [[nodiscard]] constexpr auto dominates(size_t i, size_t j) const -> bool {
+      if (sums[i] < sums[j]) {
+        return false;
+      }
+      auto strict = false;
+      for (size_t k = 0; k < m; ++k) {
+        if (value(i, k) < value(j, k)) {
+          return false;
+        }
+        strict = strict || value(j, k) < value(i, k);
+      }
+      return strict;
+    }
+
+    [[nodiscard]] constexpr auto equivalent(size_t i, size_t j) const -> bool {
+      for (size_t k = 0; k < m; ++k) {
+        if (value(i, k) != value(j, k)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    // Whether i is at least as good as j in objectives k to m - 1
+    [[nodiscard]] constexpr auto weakly_dominates_from(size_t i, size_t j, size_t k) const -> bool {
+      for (; k < m; ++k) {
+        if (value(i, k) < value(j, k)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    [[nodiscard]] constexpr auto lexicographically_greater(size_t i, size_t j) const -> bool {
+      for (size_t k = 0; k < m; ++k) {
+        if (value(i, k) != value(j, k)) {
+          return value(j, k) < value(i, k);
+        }
+      }
+      return false;
+    }
+  };
+
+  // Front of distinct solutions sorted in decreasing lexicographical
+  // order. Every solution of the first half is at least as good as every
+  // solution of the second half in the first objective, so a solution of
+  // the second front is dominated if some solution of the first front is
+  // at least as good in the remaining objectives.
+  template <typename T>
+  [[nodiscard]] static constexpr auto kung(std::span<size_t const> order, workspace<T> const& w)
+      -> std::vector<size_t> {
+    // Small fronts are computed by comparing each solution with the
+    // solutions kept before it
+    if (order.size() <= 32) {
+      auto res = std::vector<size_t>();
+      for (auto j : order) {
+        if (std::ranges::none_of(res, [&](auto i) { return w.weakly_dominates_from(i, j, 0); })) {
+          res.push_back(j);
+        }
+      }
+      return res;
+    }
+    auto const half = order.size() / 2;
+    auto res = kung(order.first(half), w);
+    auto bottom = filter(res, kung(order.subspan(half), w), 1, w);
+    res.insert(res.end(), bottom.begin(), bottom.end());
+    return res;
+  }
+
+  // Solutions of bottom that are not weakly dominated by any solution of
+  // top in objectives k to m - 1, given that every solution of top is at
+  // least as good as every solution of bottom in the objectives before k.
+  //
+  // Both sets are split by the median of objective k. The upper half of
+  // top is at least as good as the lower half of bottom in objective k,
+  // so only the objectives after k are compared between them, while the
+  // lower half of top can not dominate the upper half of bottom. The
+  // last two objectives are compared with a sweep.
+  template <typename T>
+  [[nodiscard]] static constexpr auto filter(std::vector<size_t> const& top, std::vector<size_t> bottom, size_t k,
+                                             workspace<T> const& w) -> std::vector<size_t> {
+    if (top.empty() || bottom.empty()) {
+      return bottom;
+    }
+
+    if (k + 1 == w.m) {
+      auto best = w.value(top[0], k);
+      for (auto i : top) {
+        best = std::max(best, w.value(i, k));
+      }
+      std::erase_if(bottom, [&](auto j) { return !(best < w.value(j, k)); });
+      return bottom;
+    }
+
+    // If one of the sets is small, comparing all pairs is cheaper than
+    // splitting or sorting them
+    if (std::min(top.size(), bottom.size()) <= 16) {
+      std::erase_if(bottom, [&](auto j) {
+        return std::ranges::any_of(top, [&](auto i) { return w.weakly_dominates_from(i, j, k); });
+      });
+      return bottom;
+    }
+
+    if (k + 2 == w.m) {
+      // Sweep in decreasing order of objective k, with the solutions of
+      // top first on ties, keeping the best objective k + 1 of top
+      auto points = std::vector<std::pair<size_t, bool>>();
+      points.reserve(top.size() + bottom.size());
+      for (auto i : top) {
+        points.emplace_back(i, true);
+      }
+      for (auto j : bottom) {
+        points.emplace_back(j, false);
+      }
+      std::ranges::sort(points, [&](auto const& a, auto const& b) {
+        auto const& va = w.value(a.first, k);
+        auto const& vb = w.value(b.first, k);
+        return vb < va || (!(va < vb) && a.second && !b.second);
+      });
+      auto res = std::vector<size_t>();
+      auto const* best = static_cast<T const*>(nullptr);
+      for (auto [i, is_top] : points) {
+        auto const& v = w.value(i, k + 1);
+        if (is_top) {
+          if (best == nullptr || *best < v) {
+            best = &v;
+          }
+        } else if (best == nullptr || *best < v) {
+          res.push_back(i);
+        }
+      }
+      return res;
+    }
+
+    auto values = std::vector<T>();
+    values.reserve(top.size() + bottom.size());
+    for (auto i : top) {
+      values.push_back(w.value(i, k));
+    }
+    for (auto j : bottom) {
+      values.push_back(w.value(j, k));
+    }
+    auto const range = std::ranges::minmax(values);
+    if (!(range.min < range.max)) {
+      return filter(top, std::move(bottom), k + 1, w);
+    }
+    auto const mid = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+    std::ranges::nth_element(values, mid);
+    auto const pivot = *mid;
+
+    // If the median is the minimum, the upper halves are the solutions
+    // above it, such that both halves are not empty
+    auto const upper = [&](auto i) {
+      return range.min < pivot ? !(w.value(i, k) < pivot) : pivot < w.value(i, k);
+    };
+    auto top_upper = std::vector<size_t>();
+    auto top_lower = std::vector<size_t>();
+    for (auto i : top) {
+      (upper(i) ? top_upper : top_lower).push_back(i);
+    }
+    auto bottom_upper = std::vector<size_t>();
+    auto bottom_lower = std::vector<size_t>();
+    for (auto j : bottom) {
+      (upper(j) ? bottom_upper : bottom_lower).push_back(j);
+    }
+
+    auto res = filter(top_upper, std::move(bottom_upper), k, w);
+    bottom_lower = filter(top_lower, std::move(bottom_lower), k, w);
+    bottom_lower = filter(top_upper, std::move(bottom_lower), k + 1, w);
+    res.insert(res.end(), bottom_lower.begin(), bottom_lower.end());
+    return res;
+  }
+};
+
+inline constexpr nondominated_filter_fn nondominated_filter;
+
 // CRTP Base class for sets based on an stl (or equivalent) container.
 // This means, that it can implement most required functions by default.
 template <typename Derived, typename Container>
@@ -60,6 +353,54 @@ class base_set {
     return static_cast<Derived&>(*this).insert_unchecked_impl(std::move(solution));
   }
 
+  // Inserts the solutions in a range. The solutions dominated by others
+  // in the range are discarded first with nondominated_filter, and only
+  // the remaining ones are inserted into the set (without dominance
+  // checks if the set is empty). The solutions are moved only from an
+  // rvalue range that owns them, and copied from views (e.g., a span).
+  template <std::ranges::input_range R>
+  constexpr auto insert_range(R&& range) -> void {
+    constexpr auto owning = !std::is_lvalue_reference_v<R> && !std::ranges::borrowed_range<R> &&
+                            !std::ranges::view<std::remove_cvref_t<R>>;
+    if constexpr (std::ranges::random_access_range<R> && std::ranges::sized_range<R>) {
+      auto indices = nondominated_filter(range);
+      auto solution = [&range](size_t i) -> decltype(auto) {
+        return std::ranges::begin(range)[static_cast<std::ranges::range_difference_t<R>>(i)];
+      };
+
+      // The remaining solutions do not dominate each other, so if the set
+      // is empty only equivalent ones need to be checked, which are
+      // consecutive in lexicographical order
+      auto check = std::vector<bool>(indices.size(), !empty());
+      if (empty()) {
+        std::ranges::stable_sort(indices, [&solution](auto i, auto j) {
+          return lexicographically_greater(solution(i), solution(j));
+        });
+        for (size_t k = 1; k < indices.size(); ++k) {
+          check[k] = equivalent(solution(indices[k - 1]), solution(indices[k]));
+        }
+      }
+      for (size_t k = 0; k < indices.size(); ++k) {
+        auto&& s = solution(indices[k]);
+        if constexpr (!owning) {
+          if (check[k]) {
+            insert(s);
+          } else {
+            insert_unchecked(s);
+          }
+        } else {
+          if (check[k]) {
+            insert(std::move(s));
+          } else {
+            insert_unchecked(std::move(s));
+          }
+        }
+      }
+    } else {
+      insert_range(std::vector<value_type>(std::ranges::begin(range), std::ranges::end(range)));
+    }
+  }
+
   constexpr auto erase(const_iterator it) -> iterator {
     return c.erase(it);
   }
@@ -120,26 +461,33 @@ class unordered_minimal_set : public base_set<unordered_minimal_set<Solution, Co
 
   template <typename S>
   constexpr auto insert_impl(S&& solution) -> iterator {
-    auto const first = this->c.begin();
-    auto const last = this->c.end();
-    for (auto it = first; it != last; ++it) {
-      if (dominates(*it, solution)) {
-        return last;
+    if constexpr (requires { this->c.erase_dominated(solution); }) {
+      if (!this->c.erase_dominated(solution)) {
+        return this->c.end();
       }
-      if (weakly_dominates(solution, *it)) {
-        if (equivalent(solution, *it)) {
+      return this->c.emplace(this->c.end(), std::forward<S>(solution));
+    } else {
+      auto const first = this->c.begin();
+      auto const last = this->c.end();
+      for (auto it = first; it != last; ++it) {
+        if (dominates(*it, solution)) {
           return last;
-        } else {
-          *it = std::forward<S>(solution);
-          auto remove_pred = [it](auto const& s) {
-            return dominates(*it, s);
-          };
-          this->c.erase(std::remove_if(std::next(it), last, remove_pred), last);
-          return it;
+        }
+        if (weakly_dominates(solution, *it)) {
+          if (equivalent(solution, *it)) {
+            return last;
+          } else {
+            *it = std::forward<S>(solution);
+            auto remove_pred = [it](auto const& s) {
+              return dominates(*it, s);
+            };
+            this->c.erase(std::remove_if(std::next(it), last, remove_pred), last);
+            return it;
+          }
         }
       }
+      return this->c.emplace(this->c.end(), std::forward<S>(solution));
     }
-    return this->c.emplace(this->c.end(), std::forward<S>(solution));
   }
 
   template <typename S>
@@ -216,28 +564,36 @@ class flat_minimal_set : public base_set<flat_minimal_set<Solution, Compare, Con
 
   template <typename S>
   constexpr auto insert_impl(S&& solution) -> iterator {
-    auto first = this->c.begin();
-    auto last = this->c.end();
-    auto mid = std::lower_bound(first, last, solution, compare{});
-
-    // Check for equivalent first
-    if (mid != last && equivalent(solution, *mid)) {
-      return last;
-    }
+    if constexpr (requires { this->c.erase_dominated(solution); }) {
+      if (!this->c.erase_dominated(solution)) {
+        return this->c.end();
+      }
+      auto mid = std::lower_bound(this->c.begin(), this->c.end(), solution, compare{});
+      return this->c.emplace(mid, std::forward<S>(solution));
+    } else {
+      auto first = this->c.begin();
+      auto last = this->c.end();
+      auto mid = std::lower_bound(first, last, solution, compare{});
 
-    // TODO an optimization can be made if d==2
-    for (auto it = first; it != mid; ++it) {
-      if (weakly_dominates(*it, solution)) {
+      // Check for equivalent first
+      if (mid != last && equivalent(solution, *mid)) {
         return last;
       }
-    }
 
-    // TODO this could be improved to be O(N) instead of O(2N) if at least one item is to be removed
-    auto it = this->c.emplace(mid, std::forward<S>(solution));
-    last = this->c.end();
-    auto aux = std::remove_if(std::next(it), last, [it](auto const& s) { return dominates(*it, s); });
-    this->c.erase(aux, last);
-    return it;
+      // TODO an optimization can be made if d==2
+      for (auto it = first; it != mid; ++it) {
+        if (weakly_dominates(*it, solution)) {
+          return last;
+        }
+      }
+
+      // TODO this could be improved to be O(N) instead of O(2N) if at least one item is to be removed
+      auto it = this->c.emplace(mid, std::forward<S>(solution));
+      last = this->c.end();
+      auto aux = std::remove_if(std::next(it), last, [it](auto const& s) { return dominates(*it, s); });
+      this->c.erase(aux, last);
+      return it;
+    }
   }
 
   template <typename S>
@@ -382,7 +738,8 @@ class set : public base_set<set<Solution, Compare, Container>, Container> {
   template <typename S>
   constexpr auto insert_impl(S&& solution) -> iterator {
     auto const& ov = objective_vector(solution);
-    if (ov.size() == 2) {
+    constexpr auto m = static_extent_v<decltype(ov)>;
+    if (m == 2 || (m == std::dynamic_extent && ov.size() == 2)) {
       auto last = this->c.end();
       auto it = this->c.lower_bound(solution);
       auto jt = it;
@@ -457,6 +814,1366 @@ class set : public base_set<set<Solution, Compare, Container>, Container> {
   }
 };
 
+// Sequence container that keeps its elements in contiguous blocks of
+// at most BlockSize elements, i.e., a B+tree with two levels. Inserting
+// or erasing an element only moves the elements of its block (and the
+// block handles when a block is split or emptied), and partition_point
+// does a binary search over the blocks and then within a block. The
+// iterators are bidirectional, and are invalidated by any insertion or
+// erasure.
+template <typename T, size_t BlockSize = 256>
+class blocked_vector {
+ public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = T const&;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+
+  template <bool Const>
+  class basic_iterator {
+   public:
+    using iterator_concept = std::bidirectional_iterator_tag;
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, T const*, T*>;
+    using reference = std::conditional_t<Const, T const&, T&>;
+
+    constexpr basic_iterator() = default;
+
+    template <bool C = Const>
+    requires C
+    constexpr basic_iterator(basic_iterator<false> const& other)  // NOLINT(google-explicit-constructor)
+        : m_blocks(other.m_blocks)
+        , m_block(other.m_block)
+        , m_index(other.m_index) {}
+
+    [[nodiscard]] constexpr auto operator*() const -> reference {
+      return (*m_blocks)[m_block][m_index];
+    }
+
+    [[nodiscard]] constexpr auto operator->() const -> pointer {
+      return &(*m_blocks)[m_block][m_index];
+    }
+
+    constexpr auto operator++() -> basic_iterator& {
+      if (++m_index == (*m_blocks)[m_block].size()) {
+        ++m_block;
+        m_index = 0;
+      }
+      return *this;
+    }
+
+    constexpr auto operator++(int) -> basic_iterator {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    constexpr auto operator--() -> basic_iterator& {
+      if (m_index == 0) {
+        --m_block;
+        m_index = (*m_blocks)[m_block].size();
+      }
+      --m_index;
+      return *this;
+    }
+
+    constexpr auto operator--(int) -> basic_iterator {
+      auto tmp = *this;
+      --*this;
+      return tmp;
+    }
+
+    [[nodiscard]] friend constexpr auto operator==(basic_iterator const& lhs, basic_iterator const& rhs) -> bool {
+      return lhs.m_block == rhs.m_block && lhs.m_index == rhs.m_index;
+    }
+
+   private:
+    friend blocked_vector;
+    friend basic_iterator<!Const>;
+
+    using blocks_pointer = std::conditional_t<Const, std::vector<std::vector<T>> const*, std::vector<std::vector<T>>*>;
+
+    constexpr basic_iterator(blocks_pointer blocks, size_t block, size_t index)
+        : m_blocks(blocks)
+        , m_block(block)
+        , m_index(index) {}
+
+    blocks_pointer m_blocks = nullptr;
+    size_t m_block = 0;
+    size_t m_index = 0;
+  };
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  constexpr blocked_vector() = default;
+
+  template <typename InputIt>
+  constexpr blocked_vector(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+      emplace(end(), *first);
+    }
+  }
+
+  template <typename... Args>
+  constexpr auto emplace(const_iterator pos, Args&&... args) -> iterator {
+    if (m_blocks.empty()) {
+      m_blocks.emplace_back();
+      m_blocks.back().reserve(BlockSize + 1);
+    }
+    auto b = pos.m_block;
+    auto i = pos.m_index;
+    if (b == m_blocks.size()) {
+      b = m_blocks.size() - 1;
+      i = m_blocks[b].size();
+    }
+
+    auto& block = m_blocks[b];
+    block.emplace(block.begin() + static_cast<difference_type>(i), std::forward<Args>(args)...);
+    ++m_size;
+    if (block.size() > BlockSize) {
+      auto half = block.size() / 2;
+      auto right = std::vector<T>();
+      right.reserve(BlockSize + 1);
+      right.insert(right.end(), std::make_move_iterator(block.begin() + static_cast<difference_type>(half)),
+                   std::make_move_iterator(block.end()));
+      block.erase(block.begin() + static_cast<difference_type>(half), block.end());
+      m_blocks.insert(m_blocks.begin() + static_cast<difference_type>(b + 1), std::move(right));
+      if (i >= half) {
+        ++b;
+        i -= half;
+      }
+    }
+    return iterator(&m_blocks, b, i);
+  }
+
+  constexpr auto erase(const_iterator first, const_iterator last) -> iterator {
+    if (first == last) {
+      return iterator(&m_blocks, first.m_block, first.m_index);
+    }
+
+    auto b = first.m_block;
+    auto to_difference = [](size_t i) { return static_cast<difference_type>(i); };
+    if (first.m_block == last.m_block) {
+      auto& block = m_blocks[b];
+      block.erase(block.begin() + to_difference(first.m_index), block.begin() + to_difference(last.m_index));
+      m_size -= last.m_index - first.m_index;
+    } else {
+      // Erase the tail of the first block, the blocks in between, and
+      // the head of the last block
+      auto& head = m_blocks[b];
+      m_size -= head.size() - first.m_index;
+      head.erase(head.begin() + to_difference(first.m_index), head.end());
+      for (auto k = b + 1; k < last.m_block; ++k) {
+        m_size -= m_blocks[k].size();
+      }
+      if (last.m_block < m_blocks.size()) {
+        auto& tail = m_blocks[last.m_block];
+        m_size -= last.m_index;
+        tail.erase(tail.begin(), tail.begin() + to_difference(last.m_index));
+      }
+      m_blocks.erase(m_blocks.begin() + to_difference(b + 1), m_blocks.begin() + to_difference(last.m_block));
+    }
+
+    // The position after the erased range, removing the block it was
+    // erased from if it became empty
+    auto i = first.m_index;
+    if (m_blocks[b].empty()) {
+      m_blocks.erase(m_blocks.begin() + to_difference(b));
+      i = 0;
+    } else if (i == m_blocks[b].size()) {
+      ++b;
+      i = 0;
+    }
+    if (b < m_blocks.size() && m_blocks[b].empty()) {
+      m_blocks.erase(m_blocks.begin() + to_difference(b));
+    }
+    return iterator(&m_blocks, b, i);
+  }
+
+  constexpr auto erase(const_iterator pos) -> iterator {
+    return erase(pos, std::next(pos));
+  }
+
+  // First element for which pred is false, assuming that the elements
+  // are partitioned by it.
+  template <typename Pred>
+  [[nodiscard]] constexpr auto partition_point(Pred pred) -> iterator {
+    auto b = static_cast<size_t>(
+        std::ranges::partition_point(m_blocks, [&pred](auto const& block) { return pred(block.back()); }) -
+        m_blocks.begin());
+    if (b == m_blocks.size()) {
+      return end();
+    }
+    auto i = static_cast<size_t>(std::ranges::partition_point(m_blocks[b], pred) - m_blocks[b].begin());
+    return iterator(&m_blocks, b, i);
+  }
+
+  [[nodiscard]] constexpr auto begin() -> iterator {
+    return iterator(&m_blocks, 0, 0);
+  }
+
+  [[nodiscard]] constexpr auto end() -> iterator {
+    return iterator(&m_blocks, m_blocks.size(), 0);
+  }
+
+  [[nodiscard]] constexpr auto begin() const -> const_iterator {
+    return const_iterator(&m_blocks, 0, 0);
+  }
+
+  [[nodiscard]] constexpr auto end() const -> const_iterator {
+    return const_iterator(&m_blocks, m_blocks.size(), 0);
+  }
+
+  [[nodiscard]] constexpr auto cbegin() const -> const_iterator {
+    return begin();
+  }
+
+  [[nodiscard]] constexpr auto cend() const -> const_iterator {
+    return end();
+  }
+
+  [[nodiscard]] constexpr auto size() const -> size_type {
+    return m_size;
+  }
+
+  [[nodiscard]] constexpr auto empty() const -> bool {
+    return m_size == 0;
+  }
+
+ private:
+  std::vector<std::vector<T>> m_blocks;
+  size_t m_size = 0;
+};
+
+// Sequence container of solutions that also keeps a copy of their
+// objective vectors as a structure of arrays, i.e., the values of each
+// objective are contiguous, in chunks of 64 solutions. This allows to
+// compare an objective vector with all solutions at once with `query`,
+// which compares one objective of several solutions per SIMD
+// instruction (when std::experimental::simd is available) and returns
+// the results as bitmasks, instead of comparing one pair of solutions
+// at a time. unordered_minimal_set and flat_minimal_set use
+// `erase_dominated`, which is based on the same comparisons, when a
+// dominance_block is their container.
+//
+// Since the objective vectors are copied, the solutions can not be
+// modified through the iterators, and the objective values must have
+// an arithmetic type.
+template <typename Solution>
+requires is_or_has_objective_vector<Solution>
+class dominance_block {
+ public:
+  using value_type = Solution;
+  using objective_value_type =
+      std::remove_cvref_t<std::ranges::range_value_t<decltype(objective_vector(std::declval<Solution const&>()))>>;
+  using reference = Solution const&;
+  using const_reference = Solution const&;
+  using iterator = std::vector<Solution>::const_iterator;
+  using const_iterator = std::vector<Solution>::const_iterator;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+
+  static_assert(std::is_arithmetic_v<objective_value_type> && !std::same_as<objective_value_type, bool>);
+
+  static constexpr size_t chunk_size = 64;
+
+  // Result of `query`. Bit i of word i / 64 of `dominates` (resp.
+  // `equivalent`) is set if the queried vector dominates (resp. is
+  // equivalent to) the i-th solution.
+  struct query_result {
+    bool dominated = false;
+    std::vector<uint64_t> dominates;
+    std::vector<uint64_t> equivalent;
+
+    [[nodiscard]] constexpr auto any_dominates() const -> bool {
+      return std::ranges::any_of(dominates, [](auto w) { return w != 0; });
+    }
+
+    [[nodiscard]] constexpr auto any_equivalent() const -> bool {
+      return std::ranges::any_of(equivalent, [](auto w) { return w != 0; });
+    }
+  };
+
+  dominance_block() = default;
+
+  template <typename InputIt>
+  dominance_block(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+      emplace(end(), *first);
+    }
+  }
+
+  template <typename... Args>
+  constexpr auto emplace(const_iterator pos, Args&&... args) -> iterator {
+    auto const i = static_cast<size_t>(pos - m_solutions.cbegin());
+    auto it = m_solutions.emplace(pos, std::forward<Args>(args)...);
+    auto const& ov = objective_vector(*it);
+    if (m_m == 0) {
+      m_m = static_cast<size_t>(std::ranges::size(ov));
+    }
+    assert(static_cast<size_t>(std::ranges::size(ov)) == m_m);
+
+    reserve_columns(m_solutions.size());
+    for (size_t j = 0; j < m_m; ++j) {
+      auto* col = column(j);
+      std::copy_backward(col + i, col + m_solutions.size() - 1, col + m_solutions.size());
+      col[i] = ov[j];
+    }
+    return it;
+  }
+
+  constexpr auto erase(const_iterator pos) -> iterator {
+    return erase(pos, std::next(pos));
+  }
+
+  constexpr auto erase(const_iterator first, const_iterator last) -> iterator {
+    auto const i = static_cast<size_t>(first - m_solutions.cbegin());
+    auto const k = static_cast<size_t>(last - m_solutions.cbegin());
+    for (size_t j = 0; j < m_m; ++j) {
+      auto* col = column(j);
+      std::copy(col + k, col + m_solutions.size(), col + i);
+    }
+    return m_solutions.erase(first, last);
+  }
+
+  // Erases the solutions whose bit is set in `marked`, keeping the
+  // order of the remaining ones.
+  constexpr auto erase_marked(std::span<uint64_t const> marked) -> void {
+    auto const n = m_solutions.size();
+    auto const is_marked = [&marked](size_t i) { return ((marked[i / chunk_size] >> (i % chunk_size)) & 1U) != 0; };
+    auto const w = static_cast<size_t>(std::ranges::find_if(marked, [](auto x) { return x != 0; }) - marked.begin());
+    if (w == marked.size()) {
+      return;
+    }
+    auto k = w * chunk_size + static_cast<size_t>(std::countr_zero(marked[w]));
+    for (auto i = k; i < n; ++i) {
+      if (is_marked(i)) {
+        continue;
+      }
+      if (k != i) {
+        m_solutions[k] = std::move(m_solutions[i]);
+        for (size_t j = 0; j < m_m; ++j) {
+          column(j)[k] = column(j)[i];
+        }
+      }
+      ++k;
+    }
+    m_solutions.erase(m_solutions.begin() + static_cast<difference_type>(k), m_solutions.end());
+  }
+
+  // Erases the solutions dominated by `v` and returns true, unless `v`
+  // is dominated by or equivalent to some solution, in which case the
+  // block is not modified and false is returned. This is the update of
+  // a minimal set before inserting `v`, and stops at the first chunk
+  // with a solution that weakly dominates `v`.
+  template <is_or_has_objective_vector V>
+  constexpr auto erase_dominated(V const& v) -> bool {
+    auto const& ov = objective_vector(v);
+    auto const n = m_solutions.size();
+    m_marked.clear();
+    for (size_t first = 0; first < n; first += chunk_size) {
+      auto const count = std::min(chunk_size, n - first);
+      auto [ge, le] = compare_chunk(ov, first, count);
+      if (count < chunk_size) {
+        auto const valid = (uint64_t{1} << count) - 1;
+        ge &= valid;
+        le &= valid;
+      }
+      if (ge != 0) {
+        return false;
+      }
+      m_marked.push_back(le);
+    }
+    erase_marked(m_marked);
+    return true;
+  }
+
+  constexpr auto clear() -> void {
+    m_solutions.clear();
+  }
+
+  // Compares `v` with every solution.
+  template <is_or_has_objective_vector V>
+  [[nodiscard]] auto query(V const& v) const -> query_result {
+    auto const& ov = objective_vector(v);
+    auto const n = m_solutions.size();
+    auto const words = (n + chunk_size - 1) / chunk_size;
+    auto res = query_result{false, std::vector<uint64_t>(words, 0), std::vector<uint64_t>(words, 0)};
+    if (n == 0) {
+      return res;
+    }
+    assert(static_cast<size_t>(std::ranges::size(ov)) == m_m);
+
+    for (size_t w = 0; w < words; ++w) {
+      auto const count = std::min(chunk_size, n - w * chunk_size);
+      auto [ge, le] = compare_chunk(ov, w * chunk_size, count);
+      if (count < chunk_size) {
+        auto const valid = (uint64_t{1} << count) - 1;
+        ge &= valid;
+        le &= valid;
+      }
+      res.dominated = res.dominated || (ge & ~le) != 0;
+      res.dominates[w] = le & ~ge;
+      res.equivalent[w] = ge & le;
+    }
+    return res;
+  }
+
+  [[nodiscard]] constexpr auto begin() const -> const_iterator {
+    return m_solutions.cbegin();
+  }
+
+  [[nodiscard]] constexpr auto end() const -> const_iterator {
+    return m_solutions.cend();
+  }
+
+  [[nodiscard]] constexpr auto cbegin() const -> const_iterator {
+    return m_solutions.cbegin();
+  }
+
+  [[nodiscard]] constexpr auto cend() const -> const_iterator {
+    return m_solutions.cend();
+  }
+
+  [[nodiscard]] constexpr auto size() const -> size_type {
+    return m_solutions.size();
+  }
+
+  [[nodiscard]] constexpr auto empty() const -> bool {
+    return m_solutions.empty();
+  }
+
+ private:
+  [[nodiscard]] constexpr auto column(size_t j) -> objective_value_type* {
+    return m_columns.data() + j * m_capacity;
+  }
+
+  [[nodiscard]] constexpr auto column(size_t j) const -> objective_value_type const* {
+    return m_columns.data() + j * m_capacity;
+  }
+
+  constexpr auto reserve_columns(size_t n) -> void {
+    if (n <= m_capacity) {
+      return;
+    }
+    auto capacity = std::max(chunk_size, 2 * m_capacity);
+    capacity = (std::max(capacity, n) + chunk_size - 1) / chunk_size * chunk_size;
+    auto columns = std::vector<objective_value_type>(capacity * m_m);
+    for (size_t j = 0; j < m_m; ++j) {
+      std::copy_n(column(j), std::min(m_capacity, n), columns.data() + j * capacity);
+    }
+    m_columns = std::move(columns);
+    m_capacity = capacity;
+  }
+
+  // Bitmasks of the first `count` solutions in the chunk starting at
+  // `first` that are not worse (ge) and not better (le) than `ov` in
+  // every objective. The objectives are compared one at a time for the
+  // whole chunk, until no solution of the chunk remains in either mask.
+  // The bits after `count` are unspecified.
+  template <typename OV>
+  [[nodiscard]] auto compare_chunk(OV const& ov, size_t first, size_t count) const -> std::pair<uint64_t, uint64_t> {
+    uint64_t ge = 0;
+    uint64_t le = 0;
+#ifdef MOOUTILS_SIMD
+    // Types whose comparisons are not native are compared with the
+    // scalar loop below, which is faster than expanded SIMD operations
+    if constexpr (has_native_simd_compare_v<objective_value_type>) {
+      using simd_type = std::experimental::native_simd<objective_value_type>;
+      using mask_type = typename simd_type::mask_type;
+      constexpr auto lanes = simd_type::size();
+      static_assert(chunk_size % lanes == 0);
+      auto const groups = (count + lanes - 1) / lanes;
+
+      auto mge = std::array<mask_type, chunk_size / lanes>();
+      auto mle = std::array<mask_type, chunk_size / lanes>();
+      mge.fill(mask_type(true));
+      mle.fill(mask_type(true));
+      for (size_t j = 0; j < m_m; ++j) {
+        auto const* col = column(j) + first;
+        auto const b = simd_type(static_cast<objective_value_type>(ov[j]));
+        auto any = mask_type(false);
+        for (size_t g = 0; g < groups; ++g) {
+          auto const a = simd_type(col + g * lanes, std::experimental::element_aligned);
+          mge[g] = mge[g] && (a >= b);
+          mle[g] = mle[g] && (a <= b);
+          any = any || mge[g] || mle[g];
+        }
+        if (std::experimental::none_of(any)) {
+          return {0, 0};
+        }
+      }
+      for (size_t g = 0; g < groups; ++g) {
+        if (std::experimental::none_of(mge[g] || mle[g])) {
+          continue;
+        }
+        for (size_t k = 0; k < lanes; ++k) {
+          ge |= static_cast<uint64_t>(mge[g][k]) << (g * lanes + k);
+          le |= static_cast<uint64_t>(mle[g][k]) << (g * lanes + k);
+        }
+      }
+      return {ge, le};
+    }
+#endif
+    auto sge = std::array<bool, chunk_size>();
+    auto sle = std::array<bool, chunk_size>();
+    sge.fill(true);
+    sle.fill(true);
+    for (size_t j = 0; j < m_m; ++j) {
+      auto const* col = column(j) + first;
+      auto any = false;
+      for (size_t i = 0; i < count; ++i) {
+        sge[i] = sge[i] && col[i] >= ov[j];
+        sle[i] = sle[i] && col[i] <= ov[j];
+        any = any || sge[i] || sle[i];
+      }
+      if (!any) {
+        return {0, 0};
+      }
+    }
+    for (size_t i = 0; i < count; ++i) {
+      ge |= static_cast<uint64_t>(sge[i]) << i;
+      le |= static_cast<uint64_t>(sle[i]) << i;
+    }
+    return {ge, le};
+  }
+
+  std::vector<Solution> m_solutions;
+  std::vector<objective_value_type> m_columns;
+  std::vector<uint64_t> m_marked;
+  size_t m_capacity = 0;
+  size_t m_m = 0;
+};
+
+// Minimal set for two objectives. The solutions are kept in decreasing
+// order of the first objective, such that the second objective is
+// increasing. Hence, the only solution that may weakly dominate a new
+// one is the one before its position, and the solutions it dominates
+// form a contiguous range after its position, which is erased at once.
+// Both are found with a binary search, which is done block by block
+// with the default blocked_vector container (or with std::lower_bound
+// and std::partition_point for other containers).
+template <typename Solution,                                // noformat
+          typename Compare = lexicographically_greater_fn,  // noformat
+          typename Container = blocked_vector<Solution>>
+class minimal_set2d : public base_set<minimal_set2d<Solution, Compare, Container>, Container> {
+ private:
+  using base_class_type = base_set<minimal_set2d<Solution, Compare, Container>, Container>;
+  friend base_class_type;
+
+ public:
+  using compare = Compare;
+
+  template <typename... Args>
+  explicit minimal_set2d(Args&&... args)
+      : base_class_type(std::forward<Args>(args)...) {}
+
+ private:
+  using typename base_class_type::iterator;
+
+  template <typename S>
+  constexpr auto insert_impl(S&& solution) -> iterator {
+    auto const& ov = objective_vector(solution);
+    assert(ov.size() == 2);
+    auto first = this->c.begin();
+    auto last = this->c.end();
+    auto it = partition_point(this->c.begin(), [&solution](auto const& s) { return compare{}(s, solution); });
+
+    if (it != first && objective_vector(*std::prev(it))[1] >= ov[1]) {
+      return last;
+    }
+    if (it != last && equivalent(solution, *it)) {
+      return last;
+    }
+
+    auto jt = partition_point(it, [&ov](auto const& s) { return objective_vector(s)[1] <= ov[1]; });
+    if (it == jt) {
+      return this->c.emplace(it, std::forward<S>(solution));
+    }
+    *it = std::forward<S>(solution);
+    return std::prev(this->c.erase(std::next(it), jt));
+  }
+
+  template <typename S>
+  constexpr auto insert_unchecked_impl(S&& solution) -> iterator {
+    auto mid = partition_point(this->c.begin(), [&solution](auto const& s) { return compare{}(s, solution); });
+    return this->c.emplace(mid, std::forward<S>(solution));
+  }
+
+  // Partition point of [first, end()) w.r.t. pred. Assumes that all the
+  // elements before first satisfy pred.
+  template <typename Pred>
+  [[nodiscard]] constexpr auto partition_point(iterator first, Pred pred) -> iterator {
+    if constexpr (requires { this->c.partition_point(pred); }) {
+      return this->c.partition_point(pred);
+    } else {
+      return std::partition_point(first, this->c.end(), pred);
+    }
+  }
+};
+
+// Containers whose iterators stay valid when other elements are inserted
+// or erased, as required by the tree based sets below, which refer to
+// the solutions by iterator. List-like containers (with splice) are
+// accepted, while vectors and deques are not.
+template <typename Container>
+concept is_node_container = requires(Container& c, typename Container::const_iterator it) { c.splice(it, c); };
+
+// Minimal set based on the ND-Tree of "A. Jaszkiewicz and T. Lust,
+// "ND-Tree-Based Update: A Fast Algorithm for the Dynamic
+// Nondominance Problem," in IEEE Transactions on Evolutionary
+// Computation, vol. 22, no. 5, pp. 778-791, Oct. 2018, doi:
+// 10.1109/TEVC.2018.2799684."
+//
+// The solutions are kept in a list, and the tree refers to them by
+// iterator. Each node keeps (approximations of) the ideal and nadir
+// points of its subtree, which bound the solutions in it, such that a
+// new solution is only compared with the solutions in the subtrees
+// whose bounds can dominate it or be dominated by it. The bounds are
+// only extended on insertion, so they stay valid (but may become
+// loose) when solutions are removed.
+template <typename Solution, typename Container = std::list<Solution>>
+requires is_node_container<Container>
+class nd_tree_minimal_set : public base_set<nd_tree_minimal_set<Solution, Container>, Container> {
+ private:
+  using base_class_type = base_set<nd_tree_minimal_set<Solution, Container>, Container>;
+  friend base_class_type;
+
+ public:
+  using typename base_class_type::const_iterator;
+  using typename base_class_type::iterator;
+
+  template <typename... Args>
+  explicit nd_tree_minimal_set(Args&&... args)
+      : base_class_type(std::forward<Args>(args)...) {
+    rebuild();
+  }
+
+  // The tree refers to the solutions by iterator, so it must be rebuilt
+  // for the copied solutions.
+  nd_tree_minimal_set(nd_tree_minimal_set const& other)
+      : base_class_type(other.c) {
+    rebuild();
+  }
+
+  nd_tree_minimal_set(nd_tree_minimal_set&& other) = default;
+
+  auto operator=(nd_tree_minimal_set const& other) -> nd_tree_minimal_set& {
+    if (this != &other) {
+      this->c = other.c;
+      rebuild();
+    }
+    return *this;
+  }
+
+  auto operator=(nd_tree_minimal_set&& other) -> nd_tree_minimal_set& = default;
+
+  ~nd_tree_minimal_set() = default;
+
+  constexpr auto erase(const_iterator it) -> iterator {
+    auto const& ov = objective_vector(*it);
+    auto n = find_leaf(m_root, ov, it);
+    assert(n != npos);
+    auto& points = m_nodes[n].points;
+    auto jt = std::ranges::find(points, it);
+    *jt = points.back();
+    points.pop_back();
+    if (points.empty()) {
+      remove_node(n);
+    }
+    return this->c.erase(it);
+  }
+
+  constexpr auto erase(const_iterator first, const_iterator last) -> iterator {
+    while (first != last) {
+      first = erase(first);
+    }
+    return this->c.erase(last, last);
+  }
+
+ private:
+  using objective_value_type =
+      std::remove_cvref_t<std::ranges::range_value_t<decltype(objective_vector(std::declval<Solution const&>()))>>;
+  using bound_type = std::vector<objective_value_type>;
+
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+  // Values suggested in the paper
+  static constexpr size_t max_leaf_size = 20;
+
+  struct node {
+    bound_type ideal;
+    bound_type nadir;
+    size_t parent;
+    std::vector<size_t> children;
+    std::vector<iterator> points;
+
+    [[nodiscard]] constexpr auto is_leaf() const -> bool {
+      return children.empty();
+    }
+  };
+
+  template <typename S>
+  constexpr auto insert_impl(S&& solution) -> iterator {
+    if (m_root != npos && !update(m_root, solution)) {
+      return this->c.end();
+    }
+    return insert_unchecked_impl(std::forward<S>(solution));
+  }
+
+  template <typename S>
+  constexpr auto insert_unchecked_impl(S&& solution) -> iterator {
+    auto it = this->c.emplace(this->c.end(), std::forward<S>(solution));
+    insert_node(it);
+    return it;
+  }
+
+  // Removes the solutions dominated by s from the subtree of n, and
+  // returns false if s is weakly dominated by a solution in it, in which
+  // case nothing was removed.
+  template <typename S>
+  constexpr auto update(size_t n, S const& s) -> bool {
+    auto const& ov = objective_vector(s);
+    auto& nd = m_nodes[n];
+    if (weakly_dominates(nd.nadir, ov)) {
+      return false;
+    }
+    if (weakly_dominates(ov, nd.ideal) && !equivalent(ov, nd.ideal)) {
+      remove_subtree(n);
+      return true;
+    }
+    if (!weakly_dominates(nd.ideal, ov) && !weakly_dominates(ov, nd.nadir)) {
+      return true;
+    }
+
+    if (nd.is_leaf()) {
+      for (size_t i = 0; i < nd.points.size();) {
+        if (weakly_dominates(*nd.points[i], ov)) {
+          return false;
+        } else if (dominates(ov, *nd.points[i])) {
+          this->c.erase(nd.points[i]);
+          nd.points[i] = nd.points.back();
+          nd.points.pop_back();
+        } else {
+          ++i;
+        }
+      }
+      if (nd.points.empty()) {
+        remove_node(n);
+      }
+    } else {
+      // Children may be removed while they are updated
+      for (size_t i = 0; i < nd.children.size();) {
+        auto child = nd.children[i];
+        if (!update(child, s)) {
+          return false;
+        }
+        if (i < nd.children.size() && nd.children[i] == child) {
+          ++i;
+        }
+      }
+    }
+    return true;
+  }
+
+  constexpr auto insert_node(iterator it) -> void {
+    auto const& ov = objective_vector(*it);
+    if (m_root == npos) {
+      m_root = allocate(npos);
+      m_nodes[m_root].ideal.assign(ov.begin(), ov.end());
+      m_nodes[m_root].nadir.assign(ov.begin(), ov.end());
+    }
+
+    auto n = m_root;
+    while (true) {
+      extend(m_nodes[n], ov);
+      if (m_nodes[n].is_leaf()) {
+        m_nodes[n].points.push_back(it);
+        if (m_nodes[n].points.size() > max_leaf_size) {
+          split(n);
+        }
+        return;
+      }
+      auto const node_distance = [&](auto candidate) { return distance(m_nodes[candidate], ov); };
+      n = *std::ranges::min_element(m_nodes[n].children, {}, node_distance);
+    }
+  }
+
+  // Splits a leaf into m+1 children. The first child starts with the
+  // solution furthest (on average) from the others, each of the next
+  // ones with the solution furthest from the ones chosen so far, and
+  // the remaining solutions go to the child with the closest midpoint.
+  constexpr auto split(size_t n) -> void {
+    auto points = std::move(m_nodes[n].points);
+    m_nodes[n].points.clear();
+    auto const m = m_nodes[n].ideal.size();
+
+    auto sqdist = [](auto const& a, auto const& b) {
+      auto const& oa = objective_vector(*a);
+      auto const& ob = objective_vector(*b);
+      auto d = 0.0;
+      for (size_t k = 0; k < oa.size(); ++k) {
+        auto x = static_cast<double>(oa[k]) - static_cast<double>(ob[k]);
+        d += x * x;
+      }
+      return d;
+    };
+
+    auto seeds = std::vector<size_t>();
+    auto used = std::vector<bool>(points.size(), false);
+    auto const num_children = std::min(m + 1, points.size());
+    while (seeds.size() < num_children) {
+      auto best = npos;
+      auto best_dist = -1.0;
+      for (size_t i = 0; i < points.size(); ++i) {
+        if (used[i]) {
+          continue;
+        }
+        auto d = 0.0;
+        if (seeds.empty()) {
+          for (size_t j = 0; j < points.size(); ++j) {
+            d += sqdist(points[i], points[j]);
+          }
+        } else {
+          for (auto j : seeds) {
+            d += sqdist(points[i], points[j]);
+          }
+        }
+        if (d > best_dist) {
+          best = i;
+          best_dist = d;
+        }
+      }
+      used[best] = true;
+      seeds.push_back(best);
+    }
+
+    for (auto i : seeds) {
+      auto const& ov = objective_vector(*points[i]);
+      auto child = allocate(n);
+      m_nodes[child].ideal.assign(ov.begin(), ov.end());
+      m_nodes[child].nadir.assign(ov.begin(), ov.end());
+      m_nodes[child].points.push_back(points[i]);
+      m_nodes[n].children.push_back(child);
+    }
+
+    for (size_t i = 0; i < points.size(); ++i) {
+      if (used[i]) {
+        continue;
+      }
+      auto const& ov = objective_vector(*points[i]);
+      auto child = *std::ranges::min_element(m_nodes[n].children, {},
+                                             [&](auto candidate) { return distance(m_nodes[candidate], ov); });
+      extend(m_nodes[child], ov);
+      m_nodes[child].points.push_back(points[i]);
+    }
+  }
+
+  // Removes all solutions in the subtree of n, and then n itself.
+  constexpr auto remove_subtree(size_t n) -> void {
+    auto stack = std::vector<size_t>{n};
+    while (!stack.empty()) {
+      auto k = stack.back();
+      stack.pop_back();
+      for (auto it : m_nodes[k].points) {
+        this->c.erase(it);
+      }
+      m_nodes[k].points.clear();
+      for (auto child : m_nodes[k].children) {
+        if (child != n) {
+          stack.push_back(child);
+        }
+      }
+      if (k != n) {
+        m_nodes[k].children.clear();
+        m_free.push_back(k);
+      }
+    }
+    m_nodes[n].children.clear();
+    remove_node(n);
+  }
+
+  // Removes an empty node from its parent, and the parent too if it
+  // becomes empty.
+  constexpr auto remove_node(size_t n) -> void {
+    while (true) {
+      auto parent = m_nodes[n].parent;
+      m_free.push_back(n);
+      if (parent == npos) {
+        m_root = npos;
+        return;
+      }
+      auto& children = m_nodes[parent].children;
+      children.erase(std::ranges::find(children, n));
+      if (!children.empty()) {
+        return;
+      }
+      n = parent;
+    }
+  }
+
+  template <typename V>
+  [[nodiscard]] constexpr auto find_leaf(size_t n, V const& ov, const_iterator it) const -> size_t {
+    if (n == npos || !weakly_dominates(m_nodes[n].ideal, ov) || !weakly_dominates(ov, m_nodes[n].nadir)) {
+      return npos;
+    }
+    if (m_nodes[n].is_leaf()) {
+      return std::ranges::find(m_nodes[n].points, it) != m_nodes[n].points.end() ? n : npos;
+    }
+    for (auto child : m_nodes[n].children) {
+      if (auto leaf = find_leaf(child, ov, it); leaf != npos) {
+        return leaf;
+      }
+    }
+    return npos;
+  }
+
+  constexpr auto allocate(size_t parent) -> size_t {
+    if (m_free.empty()) {
+      m_nodes.emplace_back();
+      m_nodes.back().parent = parent;
+      return m_nodes.size() - 1;
+    }
+    auto n = m_free.back();
+    m_free.pop_back();
+    m_nodes[n].parent = parent;
+    m_nodes[n].children.clear();
+    m_nodes[n].points.clear();
+    return n;
+  }
+
+  constexpr auto rebuild() -> void {
+    m_nodes.clear();
+    m_free.clear();
+    m_root = npos;
+    for (auto it = this->c.begin(); it != this->c.end(); ++it) {
+      insert_node(it);
+    }
+  }
+
+  template <typename V>
+  static constexpr auto extend(node& nd, V const& ov) -> void {
+    for (size_t k = 0; k < nd.ideal.size(); ++k) {
+      nd.ideal[k] = std::max<objective_value_type>(nd.ideal[k], ov[k]);
+      nd.nadir[k] = std::min<objective_value_type>(nd.nadir[k], ov[k]);
+    }
+  }
+
+  // Squared Euclidean distance between ov and the midpoint of the
+  // bounds of a node.
+  template <typename V>
+  [[nodiscard]] static constexpr auto distance(node const& nd, V const& ov) -> double {
+    auto d = 0.0;
+    for (size_t k = 0; k < nd.ideal.size(); ++k) {
+      auto x = (static_cast<double>(nd.ideal[k]) + static_cast<double>(nd.nadir[k])) / 2 - static_cast<double>(ov[k]);
+      d += x * x;
+    }
+    return d;
+  }
+
+  std::vector<node> m_nodes;
+  std::vector<size_t> m_free;
+  size_t m_root = npos;
+};
+
+// Minimal set based on the quad-tree of "W. Habenicht, "Quad Trees, a
+// Datastructure for Discrete Vector Optimization Problems," in
+// Essays and Surveys on Multiple Criteria Decision Making, pp. 136-145,
+// 1983," as used for Pareto archives in "S. Mostaghim and J. Teich,
+// "Quad-trees: A Data Structure for Storing Pareto Sets in
+// Multiobjective Evolutionary Algorithms with Elitism," in Evolutionary
+// Multiobjective Optimization, pp. 81-104, 2005."
+//
+// Each node holds a solution, and a solution below it is kept in the
+// child given by its successorship to that solution, i.e., the bit
+// pattern of the objectives in which it is larger. A solution can only
+// be weakly dominated by solutions in children whose pattern contains
+// its own, and only dominate solutions in children whose pattern is
+// contained in its own, so the other subtrees are skipped. Removing a
+// solution reinserts its descendants, which is cheap when the archive
+// changes little, as in low-dimensional local search. Supports up to 64
+// objectives, but is meant for a few (e.g., 3 to 5).
+template <typename Solution, typename Container = std::list<Solution>>
+requires is_node_container<Container>
+class quad_tree_minimal_set : public base_set<quad_tree_minimal_set<Solution, Container>, Container> {
+ private:
+  using base_class_type = base_set<quad_tree_minimal_set<Solution, Container>, Container>;
+  friend base_class_type;
+
+ public:
+  using typename base_class_type::const_iterator;
+  using typename base_class_type::iterator;
+
+  template <typename... Args>
+  explicit quad_tree_minimal_set(Args&&... args)
+      : base_class_type(std::forward<Args>(args)...) {
+    rebuild();
+  }
+
+  // The tree refers to the solutions by iterator, so it must be rebuilt
+  // for the copied solutions.
+  quad_tree_minimal_set(quad_tree_minimal_set const& other)
+      : base_class_type(other.c) {
+    rebuild();
+  }
+
+  quad_tree_minimal_set(quad_tree_minimal_set&& other) = default;
+
+  auto operator=(quad_tree_minimal_set const& other) -> quad_tree_minimal_set& {
+    if (this != &other) {
+      this->c = other.c;
+      rebuild();
+    }
+    return *this;
+  }
+
+  auto operator=(quad_tree_minimal_set&& other) -> quad_tree_minimal_set& = default;
+
+  ~quad_tree_minimal_set() = default;
+
+  constexpr auto erase(const_iterator it) -> iterator {
+    auto n = m_root;
+    while (m_nodes[n].it != it) {
+      auto key = successorship(*m_nodes[n].it, *it);
+      n = *std::ranges::find_if(m_nodes[n].children, [&](auto child) { return m_nodes[child].key == key; });
+    }
+    remove_nodes(std::vector<size_t>{n});
+    return this->c.erase(it);
+  }
+
+  constexpr auto erase(const_iterator first, const_iterator last) -> iterator {
+    while (first != last) {
+      first = erase(first);
+    }
+    return this->c.erase(last, last);
+  }
+
+ private:
+  using key_type = uint64_t;
+
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+  struct node {
+    iterator it;
+    key_type key;
+    size_t parent;
+    std::vector<size_t> children;
+  };
+
+  template <typename S>
+  constexpr auto insert_impl(S&& solution) -> iterator {
+    if (m_root != npos) {
+      if (weakly_dominated(m_root, solution)) {
+        return this->c.end();
+      }
+      auto dominated = std::vector<size_t>();
+      find_dominated(m_root, solution, dominated);
+      if (!dominated.empty()) {
+        for (auto n : dominated) {
+          this->c.erase(m_nodes[n].it);
+        }
+        remove_nodes(std::move(dominated));
+      }
+    }
+    return insert_unchecked_impl(std::forward<S>(solution));
+  }
+
+  template <typename S>
+  constexpr auto insert_unchecked_impl(S&& solution) -> iterator {
+    auto it = this->c.emplace(this->c.end(), std::forward<S>(solution));
+    insert_node(allocate(it));
+    return it;
+  }
+
+  // Bit i is set if b is larger than a in the i-th objective.
+  template <typename A, typename B>
+  [[nodiscard]] static constexpr auto successorship(A const& a, B const& b) -> key_type {
+    auto const& oa = objective_vector(a);
+    auto const& ob = objective_vector(b);
+    assert(oa.size() <= 64);
+    auto key = key_type{0};
+    for (size_t i = 0; i < oa.size(); ++i) {
+      if (ob[i] > oa[i]) {
+        key |= key_type{1} << i;
+      }
+    }
+    return key;
+  }
+
+  // Whether s is weakly dominated by a solution in the subtree of n.
+  template <typename S>
+  [[nodiscard]] constexpr auto weakly_dominated(size_t n, S const& s) const -> bool {
+    auto stack = std::vector<size_t>{n};
+    while (!stack.empty()) {
+      auto k = stack.back();
+      stack.pop_back();
+      auto const& x = *m_nodes[k].it;
+      if (weakly_dominates(x, s)) {
+        return true;
+      }
+      auto key = successorship(x, s);
+      for (auto child : m_nodes[k].children) {
+        if ((m_nodes[child].key & key) == key) {
+          stack.push_back(child);
+        }
+      }
+    }
+    return false;
+  }
+
+  // Appends the nodes in the subtree of n with solutions dominated by s.
+  template <typename S>
+  constexpr auto find_dominated(size_t n, S const& s, std::vector<size_t>& out) const -> void {
+    auto stack = std::vector<size_t>{n};
+    while (!stack.empty()) {
+      auto k = stack.back();
+      stack.pop_back();
+      auto const& x = *m_nodes[k].it;
+      if (dominates(s, x)) {
+        out.push_back(k);
+      }
+      auto key = successorship(x, s);
+      for (auto child : m_nodes[k].children) {
+        if ((m_nodes[child].key & ~key) == 0) {
+          stack.push_back(child);
+        }
+      }
+    }
+  }
+
+  // Inserts a detached node, with no children, in its position.
+  constexpr auto insert_node(size_t u) -> void {
+    m_nodes[u].children.clear();
+    if (m_root == npos) {
+      m_nodes[u].parent = npos;
+      m_root = u;
+      return;
+    }
+
+    auto n = m_root;
+    while (true) {
+      auto key = successorship(*m_nodes[n].it, *m_nodes[u].it);
+      auto& children = m_nodes[n].children;
+      auto jt = std::ranges::find_if(children, [&](auto child) { return m_nodes[child].key == key; });
+      if (jt == children.end()) {
+        m_nodes[u].key = key;
+        m_nodes[u].parent = n;
+        children.push_back(u);
+        return;
+      }
+      n = *jt;
+    }
+  }
+
+  // Removes the given nodes (but not their solutions) from the tree,
+  // and reinserts their descendants.
+  constexpr auto remove_nodes(std::vector<size_t> nodes) -> void {
+    auto removed = std::vector<bool>(m_nodes.size(), false);
+    for (auto n : nodes) {
+      removed[n] = true;
+    }
+
+    // Detach the subtrees of the removed nodes that are not below other
+    // removed nodes, and collect the remaining nodes in them
+    auto orphans = std::vector<size_t>();
+    for (auto n : nodes) {
+      auto p = m_nodes[n].parent;
+      auto below_removed = false;
+      for (; p != npos && !below_removed; p = m_nodes[p].parent) {
+        below_removed = removed[p];
+      }
+      if (below_removed) {
+        continue;
+      }
+
+      auto parent = m_nodes[n].parent;
+      if (parent == npos) {
+        m_root = npos;
+      } else {
+        auto& children = m_nodes[parent].children;
+        children.erase(std::ranges::find(children, n));
+      }
+
+      auto stack = std::vector<size_t>{n};
+      while (!stack.empty()) {
+        auto k = stack.back();
+        stack.pop_back();
+        stack.insert(stack.end(), m_nodes[k].children.begin(), m_nodes[k].children.end());
+        if (removed[k]) {
+          m_free.push_back(k);
+        } else {
+          orphans.push_back(k);
+        }
+      }
+    }
+
+    for (auto k : orphans) {
+      insert_node(k);
+    }
+  }
+
+  constexpr auto allocate(iterator it) -> size_t {
+    if (m_free.empty()) {
+      m_nodes.push_back(node{it, 0, npos, {}});
+      return m_nodes.size() - 1;
+    }
+    auto n = m_free.back();
+    m_free.pop_back();
+    m_nodes[n].it = it;
+    return n;
+  }
+
+  constexpr auto rebuild() -> void {
+    m_nodes.clear();
+    m_free.clear();
+    m_root = npos;
+    for (auto it = this->c.begin(); it != this->c.end(); ++it) {
+      insert_node(allocate(it));
+    }
+  }
+
+  std::vector<node> m_nodes;
+  std::vector<size_t> m_free;
+  size_t m_root = npos;
+};
+
+// Minimal set that many threads can insert into at once, such as an
+// archive shared by parallel evaluators.
+//
+// Each thread inserts into one of several shards, each a minimal set
+// (of type Set) behind its own mutex, such that threads rarely contend.
+// A shard only holds the solutions inserted since the last snapshot,
+// which is an immutable minimal set of all the solutions inserted
+// before, published as a shared pointer. Each shard keeps its own copy
+// of the pointer, which is only refreshed (under the shard mutex) when
+// the epoch of the published snapshot changes, such that inserting
+// never takes a global lock nor touches the shared reference count. A
+// solution weakly dominated by the snapshot of its shard is rejected,
+// which is the common case once the archive is stable. Calling
+// snapshot() merges the shards into a new snapshot, if any solution was
+// inserted, and readers can iterate it while the writers continue.
+//
+// Hence, insert() returning true means that the solution was not
+// weakly dominated by the last snapshot or by the solutions of its
+// shard, and the solution may still be discarded by the next merge.
+// Also, size() and empty() only refer to the last snapshot, and do not
+// merge the solutions inserted since then.
+template <typename Solution, typename Set = unordered_minimal_set<Solution>>
+requires is_or_has_objective_vector<Solution>
+class concurrent_minimal_set {
+ public:
+  using value_type = Solution;
+  using set_type = Set;
+  using snapshot_type = std::shared_ptr<set_type const>;
+  using size_type = typename set_type::size_type;
+
+  explicit concurrent_minimal_set(size_t shards = std::max(1u, std::thread::hardware_concurrency()))
+      : m_shards(std::make_unique<shard[]>(std::max(size_t{1}, shards)))
+      , m_num_shards(std::max(size_t{1}, shards))
+      , m_snapshot(std::make_shared<set_type const>()) {}
+
+  concurrent_minimal_set(concurrent_minimal_set const&) = delete;
+  auto operator=(concurrent_minimal_set const&) -> concurrent_minimal_set& = delete;
+
+  template <typename S>
+  auto insert(S&& solution) -> bool {
+    auto& sh = m_shards[shard_index()];
+    {
+      auto lock = std::lock_guard(sh.mutex);
+      auto const epoch = m_epoch.load(std::memory_order_acquire);
+      if (sh.epoch != epoch) {
+        sh.snapshot = published();
+        sh.epoch = epoch;
+      }
+      if (!sh.snapshot->empty() && weakly_dominates(*sh.snapshot, solution)) {
+        return false;
+      }
+      if (sh.set.insert(std::forward<S>(solution)) == sh.set.end()) {
+        return false;
+      }
+    }
+    // After the insertion, such that a merge that misses the solution
+    // still leaves the counter positive
+    m_pending.fetch_add(1, std::memory_order_release);
+    return true;
+  }
+
+  // Minimal set of all the solutions inserted so far.
+  [[nodiscard]] auto snapshot() const -> snapshot_type {
+    auto lock = std::lock_guard(m_merge_mutex);
+    auto current = published();
+    if (m_pending.exchange(0, std::memory_order_acq_rel) == 0) {
+      return current;
+    }
+
+    auto merged = std::make_shared<set_type>(*current);
+    for (size_t i = 0; i < m_num_shards; ++i) {
+      auto drained = set_type();
+      {
+        auto shard_lock = std::lock_guard(m_shards[i].mutex);
+        std::swap(drained, m_shards[i].set);
+      }
+      merged->insert_range(drained);
+    }
+    {
+      auto snapshot_lock = std::lock_guard(m_snapshot_mutex);
+      m_snapshot = merged;
+    }
+    // After publishing, such that a shard that sees the new epoch also
+    // gets the new (or a later) snapshot
+    m_epoch.fetch_add(1, std::memory_order_release);
+    return merged;
+  }
+
+  // Number of solutions of the last snapshot, without merging the
+  // solutions inserted since then (see snapshot()).
+  [[nodiscard]] auto size() const -> size_type {
+    return published()->size();
+  }
+
+  [[nodiscard]] auto empty() const -> bool {
+    return published()->empty();
+  }
+
+ private:
+  // Aligned to (typical) cache lines, such that threads inserting into
+  // different shards do not share them.
+  struct alignas(64) shard {
+    std::mutex mutex;
+    set_type set;
+    snapshot_type snapshot;
+    uint64_t epoch = std::numeric_limits<uint64_t>::max();
+  };
+
+  // The snapshot is only locked to copy the pointer (which is also
+  // portable to standard libraries without std::atomic<shared_ptr>),
+  // which writers only do when the epoch changes.
+  [[nodiscard]] auto published() const -> snapshot_type {
+    auto lock = std::lock_guard(m_snapshot_mutex);
+    return m_snapshot;
+  }
+
+  // Threads are assigned to shards in a round robin fashion, the first
+  // time they insert into a set of this type.
+  [[nodiscard]] auto shard_index() const -> size_t {
+    static auto next = std::atomic<size_t>(0);
+    thread_local auto const index = next.fetch_add(1, std::memory_order_relaxed);
+    return index % m_num_shards;
+  }
+
+  std::unique_ptr<shard[]> m_shards;
+  size_t m_num_shards;
+  mutable snapshot_type m_snapshot;
+  mutable std::atomic<size_t> m_pending = 0;
+  mutable std::atomic<uint64_t> m_epoch = 0;
+  mutable std::mutex m_snapshot_mutex;
+  mutable std::mutex m_merge_mutex;
+};
+
 }  // namespace mooutils
 
 #endif
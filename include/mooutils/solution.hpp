@@ -3,6 +3,9 @@
 
 #include "concepts.hpp"
 
+#include <ranges>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace mooutils {
@@ -175,8 +178,23 @@ struct decision_vectors_fn {
 
 inline constexpr decision_vectors_fn decision_vectors;
 
+// Same as objective_vector_fn, but objective vectors that are views
+// given by value (e.g., the rows of a mapped_front) are returned by
+// value, such that they do not refer to a temporary when they are the
+// elements of a transform_view.
+struct objective_vector_element_fn {
+  template <typename T>
+  [[nodiscard]] constexpr auto operator()(T&& t) const -> decltype(auto) {
+    if constexpr (!std::is_reference_v<T> && std::ranges::view<std::remove_cv_t<T>>) {
+      return std::remove_cv_t<T>(std::forward<T>(t));
+    } else {
+      return objective_vector(std::forward<T>(t));
+    }
+  }
+};
+
 struct objective_vectors_fn {
-  template <typename Range, typename OVecFn = objective_vector_fn>
+  template <typename Range, typename OVecFn = objective_vector_element_fn>
   [[nodiscard]] constexpr auto operator()(Range&& r, OVecFn&& ovec_fn = {}) const {
     return std::ranges::transform_view(std::forward<Range>(r), std::forward<OVecFn>(ovec_fn));
   }
@@ -184,6 +202,11 @@ struct objective_vectors_fn {
 
 inline constexpr objective_vectors_fn objective_vectors;
 
+// Type of the values of the objective vectors of a range of solutions.
+template <typename Range>
+using objective_value_t = std::remove_cvref_t<
+    std::ranges::range_value_t<decltype(objective_vector(*std::ranges::begin(std::declval<Range&>())))>>;
+
 struct constraint_vectors_fn {
   template <typename Range, typename CVecFn = constraint_vector_fn>
   [[nodiscard]] constexpr auto operator()(Range&& r, CVecFn&& cvec_fn = {}) const {
@@ -0,0 +1,452 @@
+#ifndef MOOUTILS_SORTING_HPP_
+#define MOOUTILS_SORTING_HPP_
+
+#include "concepts.hpp"
+#include "solution.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mooutils {
+
+// Non-dominated sorting partitions a range of solutions into fronts
+// (ranks). The solutions of rank 0 are those not dominated by any other
+// solution, and the solutions of rank r > 0 are those only dominated by
+// solutions of rank lower than r. Equivalent solutions always have the
+// same rank.
+//
+// All functions return the rank of each element of the range, which can
+// be any sized forward range (the objective vectors are copied first).
+// They also accept an optional `k`, in which case the elements not in
+// the first `k` fronts get rank `k`.
+
+// Workspace shared by the non-dominated sorting algorithms. It keeps a
+// flat copy of the distinct objective vectors (points) of a range,
+// sorted in decreasing lexicographical order, such that a point can
+// only be dominated by points that come before it.
+template <typename T>
+class nondominated_sort_workspace {
+ public:
+  template <typename R>
+  explicit nondominated_sort_workspace(R const& range)
+      : m_m(0) {
+    auto const n = static_cast<size_t>(std::ranges::size(range));
+    if (n == 0) {
+      return;
+    }
+    m_m = static_cast<size_t>(std::ranges::size(objective_vector(*std::ranges::begin(range))));
+
+    auto values = std::vector<T>();
+    values.reserve(n * m_m);
+    for (auto const& v : objective_vectors(range)) {
+      assert(static_cast<size_t>(std::ranges::size(v)) == m_m);
+      values.insert(values.end(), std::ranges::begin(v), std::ranges::end(v));
+    }
+
+    auto order = std::vector<size_t>(n);
+    std::iota(order.begin(), order.end(), size_t{0});
+    auto const greater = [this, &values](auto i, auto j) {
+      return std::lexicographical_compare(values.begin() + offset(j), values.begin() + offset(j + 1),
+                                          values.begin() + offset(i), values.begin() + offset(i + 1));
+    };
+    std::ranges::sort(order, greater);
+
+    m_point.resize(n);
+    m_values.reserve(n * m_m);
+    for (size_t k = 0; k < n; ++k) {
+      auto const i = order[k];
+      if (k == 0 || greater(order[k - 1], i)) {
+        m_values.insert(m_values.end(), values.begin() + offset(i), values.begin() + offset(i + 1));
+      }
+      m_point[i] = size() - 1;
+    }
+  }
+
+  // Number of distinct points.
+  [[nodiscard]] constexpr auto size() const -> size_t {
+    return m_m == 0 ? 0 : m_values.size() / m_m;
+  }
+
+  [[nodiscard]] constexpr auto dimension() const -> size_t {
+    return m_m;
+  }
+
+  [[nodiscard]] constexpr auto value(size_t i, size_t j) const -> T const& {
+    return m_values[i * m_m + j];
+  }
+
+  // Whether point i dominates point j considering only the first `m`
+  // objectives. Since points are distinct, it is enough that i is not
+  // worse than j in any of those objectives, assuming the remaining
+  // ones are known not to be worse either.
+  [[nodiscard]] constexpr auto dominates(size_t i, size_t j, size_t m) const -> bool {
+    auto const* vi = &m_values[i * m_m];
+    auto const* vj = &m_values[j * m_m];
+    for (size_t k = 0; k < m; ++k) {
+      if (vi[k] < vj[k]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  [[nodiscard]] constexpr auto dominates(size_t i, size_t j) const -> bool {
+    return dominates(i, j, m_m);
+  }
+
+  // Maps the ranks of the points back to the elements of the range,
+  // capping them at k.
+  [[nodiscard]] auto element_ranks(std::vector<size_t> const& ranks, size_t k) const -> std::vector<size_t> {
+    auto res = std::vector<size_t>(m_point.size());
+    for (size_t i = 0; i < m_point.size(); ++i) {
+      res[i] = std::min(ranks[m_point[i]], k);
+    }
+    return res;
+  }
+
+ private:
+  [[nodiscard]] constexpr auto offset(size_t i) const -> std::ptrdiff_t {
+    return static_cast<std::ptrdiff_t>(i * m_m);
+  }
+
+  std::vector<T> m_values;
+  std::vector<size_t> m_point;
+  size_t m_m;
+};
+
+// Efficient Non-dominated Sort (ENS) by Zhang et al. (2015). Points are
+// processed in decreasing lexicographical order, and each one is added
+// to the first front that has no point dominating it. Fronts are
+// searched either sequentially (ENS-SS) or with a binary search
+// (ENS-BS). In both cases, the points of a front are compared starting
+// from the last one added, which is the most likely to dominate it. The
+// worst case is O(mn^2), but it is usually much faster when there are
+// only a few fronts or only the first k fronts are needed, since points
+// not in those fronts are never stored.
+template <bool BinarySearch>
+struct nondominated_sort_ens_fn {
+  template <std::ranges::forward_range R>
+  requires is_objective_vector_set<R>
+  [[nodiscard]] auto operator()(R const& range, size_t k = std::numeric_limits<size_t>::max()) const
+      -> std::vector<size_t> {
+    auto const w = nondominated_sort_workspace<objective_value_t<R const>>(range);
+    auto ranks = std::vector<size_t>(w.size());
+    auto fronts = std::vector<std::vector<size_t>>();
+
+    auto const dominated = [&w](auto const& front, size_t p) {
+      return std::any_of(front.rbegin(), front.rend(), [&w, p](auto q) { return w.dominates(q, p); });
+    };
+
+    for (size_t p = 0; p < w.size(); ++p) {
+      auto f = size_t{0};
+      if constexpr (BinarySearch) {
+        auto last = fronts.size();
+        while (f < last) {
+          auto const mid = f + (last - f) / 2;
+          if (dominated(fronts[mid], p)) {
+            f = mid + 1;
+          } else {
+            last = mid;
+          }
+        }
+      } else {
+        while (f < fronts.size() && dominated(fronts[f], p)) {
+          ++f;
+        }
+      }
+      ranks[p] = f;
+      if (f < k) {
+        if (f == fronts.size()) {
+          fronts.emplace_back();
+        }
+        fronts[f].push_back(p);
+      }
+    }
+
+    return w.element_ranks(ranks, k);
+  }
+};
+
+inline constexpr nondominated_sort_ens_fn<false> nondominated_sort_ens_ss;
+inline constexpr nondominated_sort_ens_fn<true> nondominated_sort_ens_bs;
+
+// Divide-and-conquer non-dominated sorting by Jensen (2003), with the
+// generalization to arbitrary points by Fortin et al. (2013) and the
+// median splitting of Buzdalov and Shalyto (2014), which runs in
+// O(n log^{m-1} n) time.
+//
+// Points are kept sorted in decreasing lexicographical order, such that
+// the first two objectives are handled with sweeps, while the remaining
+// ones are split recursively by their median. helper_a computes the
+// ranks within a set of points that are equal in the objectives after
+// `obj`, and helper_b updates the ranks of the points in `h` with those
+// of the points in `l`, which are not worse in the objectives after
+// `obj`. All functions leave the spans of indices sorted when they
+// return. All the ranks are computed, so `k` is only used to cap them.
+struct nondominated_sort_dc_fn {
+  template <std::ranges::forward_range R>
+  requires is_objective_vector_set<R>
+  [[nodiscard]] auto operator()(R const& range, size_t k = std::numeric_limits<size_t>::max()) const
+      -> std::vector<size_t> {
+    auto const w = nondominated_sort_workspace<objective_value_t<R const>>(range);
+    auto s = state<objective_value_t<R const>>(w);
+    if (w.dimension() == 1) {
+      std::iota(s.ranks.begin(), s.ranks.end(), size_t{0});
+    } else if (w.size() > 0) {
+      auto indices = std::vector<size_t>(w.size());
+      std::iota(indices.begin(), indices.end(), size_t{0});
+      s.helper_a(indices, w.dimension() - 1);
+    }
+    return w.element_ranks(s.ranks, k);
+  }
+
+ private:
+  // Below these sizes the ranks are computed by pairwise comparisons.
+  static constexpr size_t brute_force_a_size = 64;
+  static constexpr size_t brute_force_b_size = 4096;
+
+  template <typename T>
+  struct state {
+    explicit state(nondominated_sort_workspace<T> const& workspace)
+        : w(workspace)
+        , ranks(workspace.size(), 0) {}
+
+    nondominated_sort_workspace<T> const& w;
+    std::vector<size_t> ranks;
+    std::vector<size_t> indices_buffer;
+    std::vector<T> values_buffer;
+    std::vector<size_t> tree;
+
+    auto helper_a(std::span<size_t> s, size_t obj) -> void {
+      if (s.size() < 2) {
+        return;
+      }
+      if (s.size() <= brute_force_a_size) {
+        for (size_t j = 1; j < s.size(); ++j) {
+          for (size_t i = 0; i < j; ++i) {
+            update(s[i], s[j], obj);
+          }
+        }
+        return;
+      }
+      if (obj == 1) {
+        sweep_a(s);
+        return;
+      }
+
+      auto [min, max] = minmax(s, obj);
+      if (min == max) {
+        helper_a(s, obj - 1);
+        return;
+      }
+      auto const med = median(s, {}, obj);
+      auto [g, e, l] = split(s, med, obj);
+      helper_a(g, obj);
+      helper_b(g, e, obj - 1);
+      helper_a(e, obj - 1);
+      auto ge = merge(g, e);
+      helper_b(ge, l, obj - 1);
+      helper_a(l, obj);
+      merge(ge, l);
+    }
+
+    auto helper_b(std::span<size_t> l, std::span<size_t> h, size_t obj) -> void {
+      if (l.empty() || h.empty()) {
+        return;
+      }
+      if (l.size() == 1 || h.size() == 1 || l.size() * h.size() <= brute_force_b_size) {
+        for (auto j : h) {
+          for (auto i : l) {
+            update(i, j, obj);
+          }
+        }
+        return;
+      }
+      if (obj == 1) {
+        sweep_b(l, h);
+        return;
+      }
+
+      auto [lmin, lmax] = minmax(l, obj);
+      auto [hmin, hmax] = minmax(h, obj);
+      if (hmax <= lmin) {
+        helper_b(l, h, obj - 1);
+        return;
+      }
+      if (lmax < hmin) {
+        return;
+      }
+      auto const med = median(l, h, obj);
+      auto [l1, l2, l3] = split(l, med, obj);
+      auto [h1, h2, h3] = split(h, med, obj);
+      helper_b(l1, h1, obj);
+      helper_b(l3, h3, obj);
+      auto l12 = merge(l1, l2);
+      auto h23 = merge(h2, h3);
+      helper_b(l12, h23, obj - 1);
+      merge(l12, l3);
+      merge(h1, h23);
+    }
+
+    // Updates the rank of j with that of i, if i dominates j in the
+    // objectives up to obj.
+    auto update(size_t i, size_t j, size_t obj) -> void {
+      if (w.dominates(i, j, obj + 1)) {
+        ranks[j] = std::max(ranks[j], ranks[i] + 1);
+      }
+    }
+
+    // The points in s differ only in the first two objectives, and are
+    // sorted in decreasing lexicographical order. Hence, a point is
+    // dominated by the previous ones which are not worse in the second
+    // objective. These are found with a Fenwick tree of maximum ranks
+    // indexed by the (decreasing) order of the second objective.
+    auto sweep_a(std::span<size_t> s) -> void {
+      reset_tree(s);
+      for (auto j : s) {
+        auto const pos = tree_position(w.value(j, 1));
+        ranks[j] = std::max(ranks[j], tree_query(pos));
+        tree_update(pos, ranks[j] + 1);
+      }
+    }
+
+    // Same as sweep_a, but only the points in l are added to the tree,
+    // and only the ranks of the points in h are updated.
+    auto sweep_b(std::span<size_t> l, std::span<size_t> h) -> void {
+      reset_tree(l);
+      auto it = l.begin();
+      for (auto j : h) {
+        for (; it != l.end(); ++it) {
+          auto const i = *it;
+          if (w.value(i, 0) < w.value(j, 0) || (w.value(i, 0) == w.value(j, 0) && w.value(i, 1) < w.value(j, 1))) {
+            break;
+          }
+          tree_update(tree_position(w.value(i, 1)), ranks[i] + 1);
+        }
+        ranks[j] = std::max(ranks[j], tree_query(tree_position(w.value(j, 1))));
+      }
+    }
+
+    auto reset_tree(std::span<size_t> s) -> void {
+      values_buffer.clear();
+      for (auto i : s) {
+        values_buffer.push_back(w.value(i, 1));
+      }
+      std::ranges::sort(values_buffer, std::greater<>());
+      auto last = std::unique(values_buffer.begin(), values_buffer.end());
+      values_buffer.erase(last, values_buffer.end());
+      tree.assign(values_buffer.size() + 1, 0);
+    }
+
+    // Number of values in the tree not lower than v.
+    [[nodiscard]] auto tree_position(T const& v) const -> size_t {
+      auto it = std::upper_bound(values_buffer.begin(), values_buffer.end(), v, std::greater<>());
+      return static_cast<size_t>(it - values_buffer.begin());
+    }
+
+    [[nodiscard]] auto tree_query(size_t pos) const -> size_t {
+      auto res = size_t{0};
+      for (; pos > 0; pos &= pos - 1) {
+        res = std::max(res, tree[pos]);
+      }
+      return res;
+    }
+
+    auto tree_update(size_t pos, size_t value) -> void {
+      for (; pos < tree.size(); pos += pos & (~pos + 1)) {
+        tree[pos] = std::max(tree[pos], value);
+      }
+    }
+
+    [[nodiscard]] auto minmax(std::span<size_t> s, size_t obj) const -> std::pair<T, T> {
+      auto [min, max] = std::ranges::minmax(s | std::views::transform([this, obj](auto i) { return w.value(i, obj); }));
+      return {min, max};
+    }
+
+    [[nodiscard]] auto median(std::span<size_t> s1, std::span<size_t> s2, size_t obj) -> T {
+      values_buffer.clear();
+      for (auto i : s1) {
+        values_buffer.push_back(w.value(i, obj));
+      }
+      for (auto i : s2) {
+        values_buffer.push_back(w.value(i, obj));
+      }
+      auto mid = values_buffer.begin() + static_cast<std::ptrdiff_t>(values_buffer.size() / 2);
+      std::nth_element(values_buffer.begin(), mid, values_buffer.end());
+      return *mid;
+    }
+
+    // Stable split of s into the points greater, equal, and lower than
+    // med in objective obj.
+    auto split(std::span<size_t> s, T const& med, size_t obj)
+        -> std::tuple<std::span<size_t>, std::span<size_t>, std::span<size_t>> {
+      indices_buffer.assign(s.begin(), s.end());
+      auto it = s.begin();
+      for (auto i : indices_buffer) {
+        if (w.value(i, obj) > med) {
+          *it++ = i;
+        }
+      }
+      auto const g = static_cast<size_t>(it - s.begin());
+      for (auto i : indices_buffer) {
+        if (w.value(i, obj) == med) {
+          *it++ = i;
+        }
+      }
+      auto const e = static_cast<size_t>(it - s.begin()) - g;
+      for (auto i : indices_buffer) {
+        if (w.value(i, obj) < med) {
+          *it++ = i;
+        }
+      }
+      return {s.first(g), s.subspan(g, e), s.subspan(g + e)};
+    }
+
+    // Merges two adjacent sorted spans.
+    auto merge(std::span<size_t> s1, std::span<size_t> s2) -> std::span<size_t> {
+      assert(s1.data() + s1.size() == s2.data());
+      indices_buffer.clear();
+      std::ranges::merge(s1, s2, std::back_inserter(indices_buffer));
+      std::ranges::copy(indices_buffer, s1.begin());
+      return {s1.data(), s1.size() + s2.size()};
+    }
+  };
+};
+
+inline constexpr nondominated_sort_dc_fn nondominated_sort_dc;
+
+// Non-dominated sorting with the algorithm expected to be the fastest.
+// When only the first few fronts are needed, ENS-BS is used, which
+// stops at the first k fronts, and otherwise the divide-and-conquer
+// algorithm.
+struct nondominated_sort_fn {
+  template <std::ranges::forward_range R>
+  requires is_objective_vector_set<R>
+  [[nodiscard]] auto operator()(R const& range, size_t k = std::numeric_limits<size_t>::max()) const
+      -> std::vector<size_t> {
+    if (k <= ens_max_k) {
+      return nondominated_sort_ens_bs(range, k);
+    }
+    return nondominated_sort_dc(range, k);
+  }
+
+ private:
+  static constexpr size_t ens_max_k = 4;
+};
+
+inline constexpr nondominated_sort_fn nondominated_sort;
+
+}  // namespace mooutils
+
+#endif
@@ -3,9 +3,14 @@
 #include <mooutils/indicators.hpp>
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory_resource>
+#include <numeric>
+#include <random>
 
 // In the following tests, we use a small data_type and larger
 // result_type. This is to test the case where the result does not fit
@@ -148,6 +153,249 @@ TEST_CASE("set hv 3d properties", "[indicators][hv]") {
   REQUIRE(mooutils::hv<result_type>(set, r) == mooutils::hv3d<result_type>(sorted_set, r, true));
 }
 
+TEST_CASE("set hv 3d large fronts", "[indicators][hv]") {
+  // Points whose projections on the last two objectives are mutually
+  // non-dominated, such that the 2D front of the sweep grows with every
+  // point, mixed with dominated points.
+  auto n = GENERATE(size_t(100), 5000);
+
+  using rng_type = std::mt19937_64;
+  auto rng = rng_type(n);
+  auto runif = std::uniform_int_distribution<int32_t>(1, 10000);
+  auto set = std::vector<std::vector<int32_t>>();
+  for (size_t i = 0; i < n; ++i) {
+    auto x = runif(rng);
+    set.push_back({runif(rng), x, 10001 - x});
+    set.push_back({runif(rng) / 2, x / 2, (10001 - x) / 2});
+  }
+  auto const r = std::vector<int32_t>(3, 0);
+
+  auto hv3d = mooutils::incremental_hv3dplus<result_type>(r[0], r[1], r[2]);
+  for (auto const& p : set) {
+    hv3d.insert(p);
+  }
+  REQUIRE(mooutils::hv3d<result_type>(set, r) == hv3d.value());
+}
+
+TEST_CASE("set hv 3d incremental copy", "[indicators][hv]") {
+  size_t m = 3;
+  auto n = GENERATE(size_t(10), 200);
+
+  using rng_type = std::mt19937_64;
+  auto const set = generate_nondominated_points<data_type>(n, m, rng_type(n), min_p, max_p);
+  auto const other = generate_nondominated_points<data_type>(n, m, rng_type(n + 1), min_p, max_p);
+  auto const r = std::vector(m, min_r);
+
+  // Points are kept in a pool with a custom allocator, so after
+  // inserting the second set most of the nodes have been recycled
+  auto resource = std::pmr::monotonic_buffer_resource();
+  using allocator_type = std::pmr::polymorphic_allocator<result_type>;
+  auto hv3d = mooutils::incremental_hv3dplus<result_type, allocator_type>(std::allocator_arg,
+                                                                          allocator_type(&resource), r[0], r[1], r[2]);
+  for (auto const& p : set) {
+    hv3d.insert(p);
+  }
+
+  // A copy is independent from the original
+  auto snapshot = hv3d;
+  REQUIRE(snapshot.value() == hv3d.value());
+  for (auto const& p : other) {
+    snapshot.insert(p);
+  }
+  REQUIRE(hv3d.value() == mooutils::hv3d<result_type>(set, r));
+
+  auto both = set;
+  both.insert(both.end(), other.begin(), other.end());
+  REQUIRE(snapshot.value() == mooutils::hv3d<result_type>(both, r));
+
+  // And the original still gives the same results after the copy
+  for (auto const& p : other) {
+    hv3d.insert(p);
+  }
+  REQUIRE(hv3d.value() == snapshot.value());
+
+  // Copy assignment gives an equivalent container
+  snapshot = hv3d;
+  for (auto const& p : both) {
+    REQUIRE(snapshot.contribution(p) == 0);
+  }
+}
+
+// Points that do not strictly dominate the reference point have no
+// contribution and are not inserted.
+TEST_CASE("set hv 3d reference", "[indicators][hv]") {
+  auto hv3d = mooutils::incremental_hv3dplus<result_type>(0, 0, 0);
+  REQUIRE(hv3d.insert(std::vector<result_type>{1, 1, 1}) == 1);
+  REQUIRE(hv3d.contribution(std::vector<result_type>{5, 5, -1}) == 0);
+  REQUIRE(hv3d.insert(std::vector<result_type>{5, 5, -1}) == 0);
+  REQUIRE(hv3d.insert(std::vector<result_type>{5, 5, 0}) == 0);
+  REQUIRE(hv3d.value() == 1);
+  REQUIRE(hv3d.contribution(std::vector<result_type>{2, 2, 2}) == 7);
+
+  // The same through the dynamic dispatch, and for four objectives,
+  // whose joint points are inserted into a HV3D+ structure
+  for (size_t m : {size_t(3), size_t(4)}) {
+    auto hv = mooutils::incremental_hv<result_type, std::vector<result_type>>(std::vector<result_type>(m, 0));
+    REQUIRE(hv.insert(std::vector<result_type>(m, 1)) == 1);
+    auto below = std::vector<result_type>(m, 5);
+    below.back() = -1;
+    REQUIRE(hv.contribution(below) == 0);
+    REQUIRE(hv.insert(below) == 0);
+    REQUIRE(hv.value() == 1);
+  }
+}
+
+TEST_CASE("set hv 4d properties", "[indicators][hv]") {
+  // Dimension
+  size_t m = 4;
+
+  // Number of points
+  auto n = GENERATE(size_t(2), 5, 10, 100, 500);
+
+  // Reference point
+  auto r = GENERATE_COPY(std::vector(m, max_r),  // noformat
+                         std::vector(m, min_r),  // noformat
+                         chunk(m, take(m + 10, random(min_r, max_r))));
+
+  // Seed
+  using rng_type = std::mt19937_64;
+  using rng_result_type = typename rng_type::result_type;
+  auto min_seed = std::numeric_limits<rng_result_type>::min();
+  auto max_seed = std::numeric_limits<rng_result_type>::max();
+  auto seed = GENERATE_COPY(take(5, random(min_seed, max_seed)));
+
+  auto const set = generate_nondominated_points<data_type, rng_type>(n, m, rng_type(seed), min_p, max_p);
+
+  auto aux = set;
+  std::ranges::sort(aux, mooutils::lexicographically_greater_fn{});
+  auto const sorted_set = std::move(aux);
+
+  // Non const equals same as const
+  aux = set;
+  REQUIRE(mooutils::hv<result_type>(set, r) == mooutils::hv<result_type>(aux, r));
+  aux = set;
+  REQUIRE(mooutils::hv4d<result_type>(set, r) == mooutils::hv4d<result_type>(aux, r));
+  aux = sorted_set;
+  REQUIRE(mooutils::hv4d<result_type>(sorted_set, r, true) == mooutils::hv4d<result_type>(aux, r, true));
+
+  // hv equals hv4d
+  REQUIRE(mooutils::hv<result_type>(set, r) == mooutils::hv4d<result_type>(set, r));
+
+  // hv equals hv4d
+  REQUIRE(mooutils::hv<result_type>(set, r) == mooutils::hv4d<result_type>(sorted_set, r, true));
+
+  // hv4d equals hvwfg
+  REQUIRE(mooutils::hv4d<result_type>(set, r) == mooutils::hvwfg<result_type>(set, r));
+}
+
+TEST_CASE("set hv 4d incremental", "[indicators][hv]") {
+  size_t m = 4;
+  auto n = GENERATE(size_t(1), 10, 100);
+
+  using rng_type = std::mt19937_64;
+  auto rng = rng_type(n);
+
+  // Random points in the box, such that some are dominated and some
+  // are duplicated
+  auto runif = std::uniform_int_distribution<data_type>(min_p, min_p + 10);
+  auto set = std::vector<std::vector<data_type>>(n, std::vector<data_type>(m));
+  for (auto& p : set) {
+    std::ranges::generate(p, [&] { return runif(rng); });
+  }
+  auto const r = std::vector(m, min_r);
+
+  auto hv4d = mooutils::incremental_hv4dplus<result_type>(r[0], r[1], r[2], r[3]);
+  auto hvwfg = mooutils::incremental_hvwfg<result_type, std::vector<data_type>>(r);
+  for (auto const& p : set) {
+    REQUIRE(hv4d.contribution(p) == hvwfg.contribution(p));
+    REQUIRE(hv4d.insert(p) == hvwfg.insert(p));
+    REQUIRE(hv4d.value() == hvwfg.value());
+  }
+  REQUIRE(hv4d.value() == mooutils::hv4d<result_type>(set, r));
+}
+
+TEST_CASE("set hv incremental erase", "[indicators][hv]") {
+  auto m = GENERATE(range(min_m, size_t(6)));
+  auto n = GENERATE(size_t(1), 10, 60);
+
+  using rng_type = std::mt19937_64;
+  auto rng = rng_type(n * m);
+
+  // Random points in the box, such that some are dominated and some
+  // are duplicated
+  auto runif = std::uniform_int_distribution<data_type>(min_p, min_p + 10);
+  auto set = std::vector<std::vector<data_type>>(n, std::vector<data_type>(m));
+  for (auto& p : set) {
+    std::ranges::generate(p, [&] { return runif(rng); });
+  }
+  auto const r = std::vector(m, min_r);
+
+  auto hv = mooutils::incremental_hv<result_type, std::vector<data_type>>(r);
+  auto hvwfg = mooutils::incremental_hvwfg<result_type, std::vector<data_type>>(r);
+  for (auto const& p : set) {
+    hv.insert(p);
+    hvwfg.insert(p);
+  }
+
+  // Erase the points in random order, reinstating the remaining ones,
+  // after which the value must match that of the remaining points
+  std::ranges::shuffle(set, rng);
+  while (!set.empty()) {
+    auto p = set.back();
+    set.pop_back();
+    auto const before = hv.value();
+    auto const c = hv.erase(p, set);
+    INFO("m=" << m << " n=" << n);
+    REQUIRE(hvwfg.erase(p, set) == c);
+    REQUIRE(hv.value() == before - c);
+    REQUIRE(hv.value() == hvwfg.value());
+    REQUIRE(hv.value() == mooutils::hvwfg<result_type>(set, r));
+  }
+  REQUIRE(hv.value() == 0);
+}
+
+// With objective vectors of a static size the algorithms are selected
+// at compile time, which must give the same results.
+template <size_t M>
+void check_static_hv() {
+  using point_type = std::array<data_type, M>;
+  auto rng = std::mt19937_64(M);
+  auto runif = std::uniform_int_distribution<data_type>(min_p, min_p + 10);
+  auto set = std::vector<point_type>(50);
+  for (auto& p : set) {
+    std::ranges::generate(p, [&] { return runif(rng); });
+  }
+  auto vset = std::vector<std::vector<data_type>>();
+  for (auto const& p : set) {
+    vset.emplace_back(p.begin(), p.end());
+  }
+  auto r = point_type();
+  r.fill(min_r);
+  auto const vr = std::vector<data_type>(r.begin(), r.end());
+
+  INFO("m=" << M);
+  REQUIRE(mooutils::hv<result_type>(set, r) == mooutils::hv<result_type>(vset, vr));
+  REQUIRE(mooutils::hv_contributions<result_type>(set, r) == mooutils::hv_contributions<result_type>(vset, vr));
+
+  auto hv = mooutils::incremental_hv<result_type, point_type>(r);
+  auto vhv = mooutils::incremental_hv<result_type, std::vector<data_type>>(vr);
+  for (size_t i = 0; i < set.size(); ++i) {
+    REQUIRE(hv.contribution(set[i]) == vhv.contribution(vset[i]));
+    REQUIRE(hv.insert(set[i]) == vhv.insert(vset[i]));
+  }
+  for (size_t i = 0; i < set.size(); i += 2) {
+    REQUIRE(hv.erase(set[i]) == vhv.erase(vset[i]));
+    REQUIRE(hv.value() == vhv.value());
+  }
+}
+
+TEST_CASE("set hv static size", "[indicators][hv]") {
+  check_static_hv<2>();
+  check_static_hv<3>();
+  check_static_hv<4>();
+  check_static_hv<5>();
+}
+
 TEST_CASE("set hv wfg properties", "[indicators][hv]") {
   // Dimension
   auto m = GENERATE(range(min_m, max_m));
@@ -188,6 +436,215 @@ TEST_CASE("set hv wfg properties", "[indicators][hv]") {
   REQUIRE(mooutils::hv<result_type>(set, r) == mooutils::hvwfg<result_type>(sorted_set, r, true));
 }
 
+TEST_CASE("set hv wfg workspace reuse", "[indicators][hv]") {
+  using rng_type = std::mt19937_64;
+  auto rng = rng_type(42);
+
+  // A single workspace reused for sets of increasing and decreasing
+  // sizes, and different dimensions, should give the same results as
+  // a fresh one.
+  auto workspace = mooutils::hvwfg_workspace<result_type>();
+  for (auto m : {size_t(5), size_t(4), size_t(6)}) {
+    for (auto n : {size_t(1), size_t(50), size_t(5), size_t(100), size_t(20)}) {
+      auto const set = generate_nondominated_points<data_type>(n, m, rng, min_p, max_p);
+      auto const r = std::vector(m, min_r);
+      auto const expected = mooutils::hvwfg<result_type>(set, r);
+      REQUIRE(workspace.hv(set, r) == expected);
+
+      auto const sub = std::vector(set.begin() + 1, set.end());
+      if (!sub.empty()) {
+        REQUIRE(workspace.exclhv(sub, set[0], r) == expected - mooutils::hvwfg<result_type>(sub, r));
+      }
+
+      // The contributions of an incremental structure with its own
+      // workspace or with a given one are the same
+      auto hv = mooutils::incremental_hvwfg<result_type, std::vector<data_type>>(r);
+      for (auto const& p : sub) {
+        hv.insert(p);
+      }
+      REQUIRE(hv.contribution(set[0]) == expected - hv.value());
+      REQUIRE(hv.contribution(set[0], workspace) == expected - hv.value());
+    }
+  }
+}
+
+TEST_CASE("set hv wfg parallel", "[indicators][hv]") {
+  auto m = GENERATE(size_t(2), 3, 4, 5, 6);
+  auto n = GENERATE(size_t(1), 10, 150);
+  auto threads = GENERATE(size_t(1), 2, 3, 8);
+
+  using rng_type = std::mt19937_64;
+  auto rng = rng_type(n * m);
+
+  // Integer values should match exactly
+  auto const set = generate_nondominated_points<data_type>(n, m, rng, min_p, max_p);
+  auto const r = std::vector(m, min_r);
+  REQUIRE(mooutils::hvwfg_parallel<result_type>(set, r, false, threads) == mooutils::hvwfg<result_type>(set, r));
+
+  // Floating point values should also match exactly, since the
+  // reduction order is the same
+  auto const dset = generate_nondominated_points<double>(n, m, rng, 0.0, 1.0);
+  auto const dr = std::vector(m, 0.0);
+  REQUIRE(mooutils::hvwfg_parallel<double>(dset, dr, false, threads) == mooutils::hvwfg<double>(dset, dr));
+}
+
+TEST_CASE("set hv contributions", "[indicators][hv]") {
+  auto m = GENERATE(range(min_m, size_t(7)));
+  auto n = GENERATE(size_t(1), 2, 10, 60);
+
+  using rng_type = std::mt19937_64;
+  auto rng = rng_type(n * m);
+
+  // Non-dominated points, and points in a small box such that some are
+  // dominated and some are duplicated
+  auto set = generate_nondominated_points<data_type>(n, m, rng, min_p, max_p);
+  auto runif = std::uniform_int_distribution<data_type>(min_p, min_p + 5);
+  auto box = std::vector<std::vector<data_type>>(n, std::vector<data_type>(m));
+  for (auto& p : box) {
+    std::ranges::generate(p, [&] { return runif(rng); });
+  }
+  auto const r = std::vector(m, min_r);
+
+  for (auto const& s : {set, box}) {
+    auto const total = mooutils::hvwfg<result_type>(s, r);
+    auto expected = std::vector<result_type>();
+    for (size_t i = 0; i < s.size(); ++i) {
+      auto others = s;
+      others.erase(others.begin() + static_cast<ptrdiff_t>(i));
+      expected.push_back(total - mooutils::hvwfg<result_type>(others, r));
+    }
+
+    REQUIRE(mooutils::hv_contributions<result_type>(s, r) == expected);
+    if (m == 2) {
+      REQUIRE(mooutils::hv_contributions2d<result_type>(s, r) == expected);
+    } else if (m == 3) {
+      REQUIRE(mooutils::hv_contributions3d<result_type>(s, r) == expected);
+    }
+    auto workspace = mooutils::hvwfg_workspace<result_type>();
+    REQUIRE(workspace.contributions(s, r) == expected);
+  }
+}
+
+TEST_CASE("set hv subset selection 2d", "[indicators][hv]") {
+  auto n = GENERATE(size_t(1), 5, 12);
+
+  using rng_type = std::mt19937_64;
+  auto rng = rng_type(n);
+
+  // Non-dominated points, and points in a small box such that some are
+  // dominated and some are duplicated
+  auto set = generate_nondominated_points<data_type>(n, 2, rng, min_p, max_p);
+  auto runif = std::uniform_int_distribution<data_type>(min_p, min_p + 5);
+  auto box = std::vector<std::vector<data_type>>(n, std::vector<data_type>(2));
+  for (auto& p : box) {
+    std::ranges::generate(p, [&] { return runif(rng); });
+  }
+  auto const r = std::vector<data_type>(2, min_r);
+
+  auto subset_hv = [&r](auto const& s, auto const& indices) {
+    auto aux = std::vector<std::vector<data_type>>();
+    for (auto i : indices) {
+      aux.push_back(s[i]);
+    }
+    return mooutils::hv2d<result_type>(aux, r);
+  };
+
+  for (auto const& s : {set, box}) {
+    for (size_t k = 0; k <= n + 1; ++k) {
+      // Best hypervolume over all subsets with min(k, n) points
+      auto best = result_type{0};
+      for (size_t mask = 0; mask < (size_t(1) << n); ++mask) {
+        if (static_cast<size_t>(std::popcount(mask)) == std::min(k, n)) {
+          auto indices = std::vector<size_t>();
+          for (size_t i = 0; i < n; ++i) {
+            if (mask & (size_t(1) << i)) {
+              indices.push_back(i);
+            }
+          }
+          best = std::max(best, subset_hv(s, indices));
+        }
+      }
+
+      auto res = mooutils::hv_subset_select2d<result_type>(s, r, k);
+      INFO("n=" << n << " k=" << k);
+      REQUIRE(res.size() == std::min(k, n));
+      REQUIRE(std::ranges::is_sorted(res));
+      REQUIRE(std::ranges::adjacent_find(res) == res.end());
+      REQUIRE(subset_hv(s, res) == best);
+      REQUIRE(mooutils::hv_subset_select<result_type>(s, r, k) == res);
+      REQUIRE(subset_hv(s, mooutils::hv_subset_select_forward<result_type>(s, r, k)) <= best);
+      REQUIRE(subset_hv(s, mooutils::hv_subset_select_backward<result_type>(s, r, k)) <= best);
+    }
+  }
+}
+
+TEST_CASE("set hv subset selection greedy", "[indicators][hv]") {
+  auto m = GENERATE(range(min_m, size_t(6)));
+  auto n = GENERATE(size_t(1), 10, 30);
+
+  using rng_type = std::mt19937_64;
+  auto rng = rng_type(n * m);
+
+  auto subset_hv = []<typename T>(auto const& s, auto const& indices, auto const& r, T) {
+    auto aux = std::remove_cvref_t<decltype(s)>();
+    for (auto i : indices) {
+      aux.push_back(s[i]);
+    }
+    return mooutils::hvwfg<T>(aux, r);
+  };
+
+  // Forward selection against the naive greedy algorithm, which breaks
+  // ties in the same way, in a box with dominated and duplicated points
+  auto runif = std::uniform_int_distribution<data_type>(min_p, min_p + 10);
+  auto box = std::vector<std::vector<data_type>>(n, std::vector<data_type>(m));
+  for (auto& p : box) {
+    std::ranges::generate(p, [&] { return runif(rng); });
+  }
+  auto const r = std::vector(m, min_r);
+
+  auto expected = std::vector<size_t>();
+  for (size_t k = 0; k <= n; ++k) {
+    auto sorted = expected;
+    std::ranges::sort(sorted);
+    INFO("m=" << m << " n=" << n << " k=" << k);
+    REQUIRE(mooutils::hv_subset_select_forward<result_type>(box, r, k) == sorted);
+
+    auto best = std::pair<result_type, size_t>{-1, 0};
+    for (size_t i = 0; i < n; ++i) {
+      if (std::ranges::find(expected, i) == expected.end()) {
+        auto aux = expected;
+        aux.push_back(i);
+        best = std::max(best, {subset_hv(box, aux, r, result_type{}), n - i});
+      }
+    }
+    expected.push_back(n - best.second);
+  }
+
+  // Backward elimination against the naive algorithm, with real valued
+  // non-dominated points such that there are no ties
+  auto set = generate_nondominated_points<double>(n, m, rng, 0.0, 1.0);
+  auto const dr = std::vector(m, 0.0);
+  auto remaining = std::vector<size_t>(n);
+  std::iota(remaining.begin(), remaining.end(), size_t{0});
+  for (size_t k = n + 1; k-- > 0;) {
+    INFO("m=" << m << " n=" << n << " k=" << k);
+    auto res = mooutils::hv_subset_select_backward<double>(set, dr, k);
+    REQUIRE(res.size() == std::min(k, n));
+    REQUIRE(subset_hv(set, res, dr, double{}) == Approx(subset_hv(set, remaining, dr, double{})));
+    REQUIRE(subset_hv(set, mooutils::hv_subset_select_forward<double>(set, dr, k), dr, double{}) <=
+            Approx(mooutils::hvwfg<double>(set, dr)));
+
+    if (!remaining.empty() && k <= remaining.size()) {
+      auto aux = std::vector<std::vector<double>>();
+      for (auto i : remaining) {
+        aux.push_back(set[i]);
+      }
+      auto c = mooutils::hv_contributions<double>(aux, dr);
+      remaining.erase(remaining.begin() + std::ranges::distance(c.begin(), std::ranges::min_element(c)));
+    }
+  }
+}
+
 struct HypervolumeDataset {
   using ovec_type = std::vector<data_type>;
   using set_type = std::vector<ovec_type>;
@@ -260,6 +717,10 @@ TEST_CASE("set hv results", "[indicators][hv]") {
     } else if (hvdata.m == 3) {
       auto hv3d = mooutils::incremental_hv3dplus<result_type>(hvdata.refp[0], hvdata.refp[1], hvdata.refp[2]);
       REQUIRE(test_hv_struct(hv3d, hvdata) == true);
+    } else if (hvdata.m == 4) {
+      auto hv4d = mooutils::incremental_hv4dplus<result_type>(hvdata.refp[0], hvdata.refp[1], hvdata.refp[2],
+                                                              hvdata.refp[3]);
+      REQUIRE(test_hv_struct(hv4d, hvdata) == true);
     }
     auto hvwfg = mooutils::incremental_hvwfg<result_type, decltype(hvdata.refp)>(hvdata.refp);
     REQUIRE(test_hv_struct(hvwfg, hvdata) == true);
@@ -0,0 +1,250 @@
+#include <catch2/catch.hpp>
+
+#include <mooutils/indicators.hpp>
+#include <mooutils/io.hpp>
+#include <mooutils/orders.hpp>
+#include <mooutils/sets.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+static_assert(mooutils::is_objective_vector_set<mooutils::mapped_front<double>>);
+static_assert(std::ranges::random_access_range<mooutils::mapped_front<int32_t>>);
+static_assert(std::ranges::input_range<mooutils::hvdata_reader<double>>);
+
+// Temporary file that is removed at the end of a test
+struct temporary_file {
+  std::filesystem::path path;
+
+  explicit temporary_file(std::string const& name)
+      : path(std::filesystem::temp_directory_path() / name) {}
+
+  ~temporary_file() {
+    std::filesystem::remove(path);
+  }
+};
+
+template <typename T>
+auto random_points(size_t n, size_t m, uint64_t seed) {
+  auto rng = std::mt19937_64(seed);
+  auto runif = std::uniform_int_distribution<int>(0, 100);
+  auto points = std::vector<std::vector<T>>(n, std::vector<T>(m));
+  for (auto& p : points) {
+    std::ranges::generate(p, [&] { return static_cast<T>(runif(rng)); });
+  }
+  return points;
+}
+
+TEMPLATE_TEST_CASE("front file rows", "[io]", int8_t, int32_t, uint64_t, float, double) {
+  auto n = GENERATE(size_t(0), size_t(1), size_t(100), size_t(100000));
+  auto m = GENERATE(size_t(1), size_t(3), size_t(7));
+  auto points = random_points<TestType>(n, m, n * m);
+  auto file = temporary_file("mooutils_front_rows.bin");
+
+  mooutils::write_front<TestType>(file.path, points);
+  auto front = mooutils::mapped_front<TestType>(file.path);
+  REQUIRE(front.layout() == mooutils::front_layout::rows);
+  REQUIRE(front.size() == n);
+  REQUIRE(front.points() == n);
+  REQUIRE(front.has_reference() == false);
+  REQUIRE(std::ranges::equal(front, points, [](auto const& a, auto const& b) { return std::ranges::equal(a, b); }));
+  for (size_t i = 0; i < n; i += 97) {
+    REQUIRE(std::ranges::equal(front[i], points[i]));
+    REQUIRE(reinterpret_cast<uintptr_t>(front[i].data()) % alignof(TestType) == 0);
+  }
+  if (n > 0) {
+    REQUIRE(front.objectives() == m);
+  }
+
+  // Moving keeps the same mapping
+  auto moved = std::move(front);
+  REQUIRE(std::ranges::equal(moved.values(), points | std::views::join));
+}
+
+// Rows are spans into the file returned by value, such that they do not
+// refer to the iterator and can be used with reverse iterators.
+TEST_CASE("front file reverse rows", "[io]") {
+  auto points = std::vector<std::vector<double>>{{1, 2}, {3, 4}, {5, 6}};
+  auto file = temporary_file("mooutils_front_reverse.bin");
+  mooutils::write_front<double>(file.path, points);
+  auto front = mooutils::mapped_front<double>(file.path);
+
+  REQUIRE(std::ranges::equal(front | std::views::reverse, points | std::views::reverse,
+                             [](auto const& a, auto const& b) { return std::ranges::equal(a, b); }));
+  REQUIRE(std::ranges::equal(mooutils::objective_vectors(front) | std::views::reverse, points | std::views::reverse,
+                             [](auto const& a, auto const& b) { return std::ranges::equal(a, b); }));
+  REQUIRE(std::ranges::equal(*std::prev(front.end()), points.back()));
+  REQUIRE(std::ranges::equal(*std::ranges::prev(front.end(), 2), points[1]));
+
+  auto it = front.begin();
+  auto const& first = *it;
+  auto const& second = *++it;
+  REQUIRE(std::ranges::equal(first, points[0]));
+  REQUIRE(std::ranges::equal(second, points[1]));
+  REQUIRE(std::ranges::equal(mooutils::objective_vector(*it), points[1]));
+}
+
+TEST_CASE("front file columns", "[io]") {
+  auto points = random_points<double>(1000, 4, 1);
+  auto reference = std::vector<int>{-1, -2, -3, -4};
+  auto file = temporary_file("mooutils_front_columns.bin");
+
+  mooutils::write_front<double>(file.path, points, reference, mooutils::front_layout::columns);
+  auto front = mooutils::mapped_front<double>(file.path);
+  REQUIRE(front.layout() == mooutils::front_layout::columns);
+  REQUIRE(front.points() == points.size());
+  REQUIRE_THROWS_AS(front.size(), std::logic_error);
+  REQUIRE_THROWS_AS(front.empty(), std::logic_error);
+  REQUIRE_THROWS_AS(front.begin(), std::logic_error);
+  REQUIRE_THROWS_AS(mooutils::hv<double>(front, front.reference()), std::logic_error);
+  REQUIRE(front.objectives() == 4);
+  REQUIRE(std::ranges::equal(front.reference(), std::vector<double>{-1, -2, -3, -4}));
+  for (size_t j = 0; j < 4; ++j) {
+    REQUIRE(std::ranges::equal(front.column(j), points | std::views::transform([j](auto const& p) { return p[j]; })));
+  }
+}
+
+TEST_CASE("front file errors", "[io]") {
+  auto file = temporary_file("mooutils_front_errors.bin");
+  mooutils::write_front<float>(file.path, random_points<float>(10, 2, 2));
+  REQUIRE_THROWS(mooutils::mapped_front<double>(file.path));
+
+  // Truncated payload
+  std::filesystem::resize_file(file.path, std::filesystem::file_size(file.path) - 1);
+  REQUIRE_THROWS(mooutils::mapped_front<float>(file.path));
+
+  // Not a front file
+  std::ofstream(file.path) << "10 2\n1 2\n";
+  REQUIRE_THROWS(mooutils::mapped_front<float>(file.path));
+
+  // Headers with sizes such that the bounds would overflow
+  auto const corrupt = std::vector<mooutils::front_header>{
+      {mooutils::front_scalar_type::float64, mooutils::front_layout::rows, false, 1, uint64_t{1} << 61, 64},
+      {mooutils::front_scalar_type::float64, mooutils::front_layout::rows, true, 1, uint64_t{1} << 61, 64},
+      {mooutils::front_scalar_type::float64, mooutils::front_layout::rows, false, uint64_t{1} << 61, 8, 64},
+      {mooutils::front_scalar_type::float64, mooutils::front_layout::rows, false, 1, 1, ~uint64_t{63}},
+      {mooutils::front_scalar_type::float64, mooutils::front_layout::rows, false, ~uint64_t{0}, 0, 64},
+  };
+  for (auto const& header : corrupt) {
+    auto const bytes = header.serialize();
+    auto os = std::ofstream(file.path, std::ios::binary | std::ios::trunc);
+    os.write(reinterpret_cast<char const*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    os.write(std::vector<char>(128).data(), 128);
+    os.close();
+    REQUIRE_THROWS(mooutils::mapped_front<double>(file.path));
+  }
+}
+
+// The mapped objective vectors can be used directly by the indicators,
+// orders and sets.
+TEST_CASE("front file indicators", "[io]") {
+  auto points = random_points<int32_t>(500, 3, 3);
+  auto reference = std::vector<int32_t>{-1, -1, -1};
+  auto file = temporary_file("mooutils_front_indicators.bin");
+  mooutils::write_front<int32_t>(file.path, points, reference);
+  auto front = mooutils::mapped_front<int32_t>(file.path);
+
+  REQUIRE(mooutils::hv<int64_t>(front, front.reference()) == mooutils::hv<int64_t>(points, reference));
+  REQUIRE(mooutils::weakly_dominates(front, points));
+
+  auto set = mooutils::unordered_minimal_set<std::span<int32_t const>>();
+  auto expected = mooutils::unordered_minimal_set<std::vector<int32_t>>();
+  for (size_t i = 0; i < front.size(); ++i) {
+    set.insert(front[i]);
+    expected.insert(points[i]);
+  }
+  REQUIRE(set.size() == expected.size());
+}
+
+TEMPLATE_TEST_CASE("hvdata file", "[io][hvdata]", int16_t, int64_t, float, double) {
+  auto n = GENERATE(size_t(0), size_t(1), size_t(1000));
+  auto m = GENERATE(size_t(1), size_t(4));
+  auto buffer_size = GENERATE(size_t(1), size_t(1 << 20));
+  auto points = random_points<TestType>(n, m, n + m);
+  if constexpr (std::is_floating_point_v<TestType>) {
+    for (auto& p : points) {
+      std::ranges::transform(p, p.begin(), [](auto v) { return v / 7; });
+    }
+  }
+  auto reference = std::vector<TestType>(m, TestType{0});
+  auto file = temporary_file("mooutils_hvdata.dat");
+
+  mooutils::write_hvdata(file.path, points, reference, int64_t{1234567890123});
+  auto reader = mooutils::hvdata_reader<TestType, int64_t>(file.path, buffer_size);
+  REQUIRE(reader.points() == n);
+  REQUIRE(reader.objectives() == m);
+  REQUIRE(reader.hv() == 1234567890123);
+  REQUIRE(reader.reference() == reference);
+  auto read = std::vector<std::vector<TestType>>();
+  for (auto const& p : reader) {
+    read.push_back(p);
+  }
+  REQUIRE(read == points);
+}
+
+TEST_CASE("hvdata file errors", "[io][hvdata]") {
+  auto file = temporary_file("mooutils_hvdata_errors.dat");
+  REQUIRE_THROWS(mooutils::hvdata_reader<int>(file.path));
+
+  std::ofstream(file.path) << "2 2\n10\n0 0\n1 2\n3";
+  auto reader = mooutils::hvdata_reader<int>(file.path);
+  auto it = reader.begin();
+  REQUIRE(*it == std::vector<int>{1, 2});
+  REQUIRE_THROWS(++it);
+
+  std::ofstream(file.path) << "1 2\n10\n0 0\n1 x\n";
+  REQUIRE_THROWS(mooutils::hvdata_reader<int>(file.path));
+}
+
+// The reader gives the same values as parsing the hv test data with
+// iostreams.
+TEST_CASE("hvdata file resources", "[io][hvdata]") {
+  auto datadir = std::filesystem::path(TEST_RESOURCES_DIR) / "hvdata" / "data";
+  auto count = 0;
+  for (auto const& entry : std::filesystem::directory_iterator(datadir)) {
+    auto const& path = entry.path();
+    auto is = std::ifstream(path);
+    auto n = size_t{0};
+    auto m = size_t{0};
+    auto hv = int64_t{0};
+    is >> n >> m >> hv;
+    auto values = std::vector<int32_t>(std::istream_iterator<int32_t>(is), std::istream_iterator<int32_t>());
+    REQUIRE(values.size() == (n + 1) * m);
+
+    auto reader = mooutils::hvdata_reader<int32_t, int64_t>(path, 256);
+    REQUIRE(reader.points() == n);
+    REQUIRE(reader.objectives() == m);
+    REQUIRE(reader.hv() == hv);
+    REQUIRE(std::ranges::equal(reader.reference(), std::span(values).first(m)));
+    auto i = m;
+    for (auto const& p : reader) {
+      REQUIRE(std::ranges::equal(p, std::span(values).subspan(i, m)));
+      i += m;
+    }
+    REQUIRE(i == values.size());
+    ++count;
+  }
+  REQUIRE(count > 0);
+}
+
+// The points of a text front file can be inserted into a set and an
+// incremental indicator while they are read.
+TEST_CASE("hvdata file streaming", "[io][hvdata]") {
+  auto path = std::filesystem::path(TEST_RESOURCES_DIR) / "hvdata" / "data" / "hv_200_3_0.dat";
+  auto reader = mooutils::hvdata_reader<int32_t, int64_t>(path);
+  auto set = mooutils::unordered_minimal_set<std::vector<int32_t>>();
+  auto ihv = mooutils::incremental_hv<int64_t, std::vector<int32_t>>(reader.reference());
+  for (auto const& p : reader) {
+    set.insert(p);
+    ihv.insert(p);
+  }
+  REQUIRE(ihv.value() == reader.hv());
+  REQUIRE(mooutils::hv<int64_t>(set, reader.reference()) == reader.hv());
+}
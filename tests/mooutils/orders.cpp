@@ -2,6 +2,13 @@
 
 #include <mooutils/orders.hpp>
 
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <span>
+#include <vector>
+
 // TODO improve sets/vectors generation
 
 constexpr size_t min_m{2};
@@ -341,3 +348,86 @@ TEST_CASE("incomparable sets", "[orders][dominance]") {
   REQUIRE(mooutils::strictly_dominates(s1, s2) == false);
   REQUIRE(mooutils::incomparable(s1, s2) == true);
 }
+
+// Contiguous objective vectors are compared with a different (SIMD)
+// implementation, so they are checked against the same vectors in a
+// non-contiguous container, for several lengths and value types.
+TEMPLATE_TEST_CASE("contiguous vectors", "[orders][dominance]", int8_t, int32_t, uint16_t, float, double) {
+  auto m = GENERATE(range(size_t{1}, size_t{35}));
+  auto rng = std::mt19937_64(m);
+  auto dist = std::uniform_int_distribution<int>(0, 2);
+
+  for (size_t r = 0; r < repeats; ++r) {
+    auto v1 = std::vector<TestType>(m);
+    auto v2 = std::vector<TestType>(m);
+    // Make most pairs comparable by only changing a few values
+    for (size_t i = 0; i < m; ++i) {
+      v1[i] = static_cast<TestType>(dist(rng));
+      v2[i] = (r % 2 == 0 || dist(rng) == 0) ? static_cast<TestType>(dist(rng)) : v1[i];
+    }
+    auto d1 = std::deque<TestType>(v1.begin(), v1.end());
+    auto d2 = std::deque<TestType>(v2.begin(), v2.end());
+    auto s1 = std::span<TestType const>(v1);
+
+    REQUIRE(mooutils::equivalent(v1, v2) == mooutils::equivalent(d1, d2));
+    REQUIRE(mooutils::weakly_dominates(v1, v2) == mooutils::weakly_dominates(d1, d2));
+    REQUIRE(mooutils::dominates(v1, v2) == mooutils::dominates(d1, d2));
+    REQUIRE(mooutils::strictly_dominates(v1, v2) == mooutils::strictly_dominates(d1, d2));
+    REQUIRE(mooutils::incomparable(v1, v2) == mooutils::incomparable(d1, d2));
+    REQUIRE(mooutils::dominates(s1, v2) == mooutils::dominates(d1, d2));
+    REQUIRE(mooutils::dominates(v2, s1) == mooutils::dominates(d2, d1));
+  }
+}
+
+TEST_CASE("constant evaluated vectors", "[orders][dominance]") {
+  constexpr auto v1 = std::array{3.0, 2.0, 1.0, 1.0, 5.0};
+  constexpr auto v2 = std::array{3.0, 1.0, 1.0, 0.0, 5.0};
+  STATIC_REQUIRE(mooutils::dominates(v1, v2));
+  STATIC_REQUIRE(mooutils::weakly_dominates(v1, v2));
+  STATIC_REQUIRE(!mooutils::strictly_dominates(v1, v2));
+  STATIC_REQUIRE(!mooutils::incomparable(v1, v2));
+  STATIC_REQUIRE(!mooutils::equivalent(v1, v2));
+}
+
+// Objective vectors of a static size are compared with fully unrolled
+// loops, also when only one of them has a static size.
+template <size_t M>
+void check_static_vectors() {
+  auto rng = std::mt19937_64(M);
+  auto dist = std::uniform_int_distribution<int>(0, 2);
+
+  for (size_t r = 0; r < repeats; ++r) {
+    auto a1 = std::array<double, M>();
+    auto a2 = std::array<int, M>();
+    for (size_t i = 0; i < M; ++i) {
+      a1[i] = dist(rng);
+      a2[i] = (r % 2 == 0 || dist(rng) == 0) ? dist(rng) : static_cast<int>(a1[i]);
+    }
+    auto v2 = std::vector<int>(a2.begin(), a2.end());
+    auto s2 = std::span<int const, M>(v2);
+    auto d1 = std::deque<double>(a1.begin(), a1.end());
+    auto d2 = std::deque<int>(a2.begin(), a2.end());
+
+    REQUIRE(mooutils::equivalent(a1, a2) == mooutils::equivalent(d1, d2));
+    REQUIRE(mooutils::weakly_dominates(a1, a2) == mooutils::weakly_dominates(d1, d2));
+    REQUIRE(mooutils::dominates(a1, a2) == mooutils::dominates(d1, d2));
+    REQUIRE(mooutils::strictly_dominates(a1, a2) == mooutils::strictly_dominates(d1, d2));
+    REQUIRE(mooutils::incomparable(a1, a2) == mooutils::incomparable(d1, d2));
+    REQUIRE(mooutils::dominates(v2, a1) == mooutils::dominates(d2, d1));
+    REQUIRE(mooutils::dominates(d1, s2) == mooutils::dominates(d1, d2));
+  }
+}
+
+TEST_CASE("static vectors", "[orders][dominance]") {
+  STATIC_REQUIRE(mooutils::static_extent_v<std::array<double, 3> const&> == 3);
+  STATIC_REQUIRE(mooutils::static_extent_v<std::span<int, 4>> == 4);
+  STATIC_REQUIRE(mooutils::static_extent_v<std::span<int>> == std::dynamic_extent);
+  STATIC_REQUIRE(mooutils::static_extent_v<std::vector<int>> == std::dynamic_extent);
+
+  check_static_vectors<1>();
+  check_static_vectors<2>();
+  check_static_vectors<3>();
+  check_static_vectors<4>();
+  check_static_vectors<8>();
+  check_static_vectors<17>();
+}
@@ -1,8 +1,15 @@
 #include <catch2/catch.hpp>
 
 #include <mooutils/queues.hpp>
+#include <mooutils/random.hpp>
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
 #include <random>
+#include <thread>
+#include <vector>
 
 TEST_CASE("fifo queue", "[queues]") {
   int n = GENERATE(10, 100, 1000);
@@ -56,3 +63,239 @@ TEST_CASE("random queue", "[queues]") {
   REQUIRE(int(queue.size()) == 0);
   REQUIRE(queue.empty() == true);
 }
+
+// Random pushes, key updates and erases, after which the solutions
+// must be popped in decreasing order of their (last) keys.
+TEMPLATE_TEST_CASE_SIG("priority queue", "[queues]", ((size_t Arity), Arity), 2, 4, 8) {
+  int n = GENERATE(10, 100, 1000);
+  auto rng = std::mt19937_64(static_cast<uint64_t>(n));
+  auto runif = std::uniform_int_distribution<int>(0, n / 2);
+
+  // Key of a solution (an index), which can be changed from outside
+  auto keys = std::vector<int>(size_t(n));
+  std::ranges::generate(keys, [&] { return runif(rng); });
+  auto key = [&keys](int const &i) { return keys[size_t(i)]; };
+  auto queue = mooutils::priority_queue<int, decltype(key), std::less<>, Arity>(key);
+
+  auto handles = std::vector<mooutils::priority_queue_handle>();
+  for (int i = 0; i < n; ++i) {
+    handles.push_back(queue.push(i));
+  }
+  REQUIRE(int(queue.size()) == n);
+
+  auto erased = std::vector<bool>(size_t(n), false);
+  for (int k = 0; k < n; ++k) {
+    auto i = size_t(runif(rng) * 2 % n);
+    if (erased[i]) {
+      continue;
+    }
+    if (k % 3 == 0) {
+      REQUIRE(queue.erase(handles[i]) == int(i));
+      REQUIRE(queue.contains(handles[i]) == false);
+      erased[i] = true;
+    } else if (k % 3 == 1) {
+      keys[i] = runif(rng);
+      queue.update_key(handles[i]);
+    } else {
+      keys[i] = runif(rng);
+      queue.update_key(handles[i], keys[i]);
+    }
+    REQUIRE(queue.top_key() == key(queue.top()));
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (!erased[i]) {
+      REQUIRE(queue[handles[i]] == int(i));
+      REQUIRE(queue.key(handles[i]) == keys[i]);
+    }
+  }
+
+  // Change all keys at once
+  std::ranges::generate(keys, [&] { return runif(rng); });
+  queue.update_keys();
+
+  auto expected = std::vector<int>();
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (!erased[i]) {
+      expected.push_back(keys[i]);
+    }
+  }
+  std::ranges::sort(expected, std::greater<>{});
+  auto popped = std::vector<int>();
+  while (!queue.empty()) {
+    popped.push_back(key(queue.pop()));
+  }
+  REQUIRE(popped == expected);
+
+  // Handle indices are reused, but the old handles stay stale
+  auto h = queue.push(0);
+  REQUIRE(h.index < size_t(n));
+  REQUIRE(queue.contains(h));
+  REQUIRE(std::ranges::none_of(handles, [&queue](auto old) { return queue.contains(old); }));
+}
+
+// Popping in batches gives the same solutions as popping one at a time
+// with the same seed.
+TEMPLATE_TEST_CASE("random queue pop n", "[queues]", std::mt19937_64, mooutils::xoshiro256plusplus) {
+  int n = GENERATE(10, 100, 1000);
+  size_t k = GENERATE(1, 7, 64);
+  auto seed = GENERATE(take(3, random(0, 1000000)));
+
+  auto values = std::vector<int>(size_t(n));
+  std::iota(values.begin(), values.end(), 0);
+  auto queue1 = mooutils::random_queue<int, TestType>(TestType(static_cast<uint64_t>(seed)));
+  auto queue2 = mooutils::random_queue<int, TestType>(TestType(static_cast<uint64_t>(seed)), values);
+  for (int i = 0; i < n; ++i) {
+    queue1.push(i);
+  }
+
+  auto popped1 = std::vector<int>();
+  auto popped2 = std::vector<int>();
+  while (!queue1.empty()) {
+    auto const before = queue1.size();
+    queue1.pop_n(k, std::back_inserter(popped1));
+    REQUIRE(queue1.size() == before - std::min(before, k));
+  }
+  while (!queue2.empty()) {
+    popped2.push_back(queue2.pop());
+  }
+  REQUIRE(popped1 == popped2);
+  std::ranges::sort(popped1);
+  REQUIRE(popped1 == values);
+
+  // Reseeding repeats the same order
+  queue1.seed(static_cast<uint64_t>(seed));
+  for (int i = 0; i < n; ++i) {
+    queue1.push(i);
+  }
+  auto popped3 = std::vector<int>();
+  queue1.pop_n(size_t(n), std::back_inserter(popped3));
+  REQUIRE(popped3 == popped2);
+}
+
+TEST_CASE("concurrent fifo queue", "[queues]") {
+  int n = GENERATE(10, 100, 1000);
+  auto queue = mooutils::concurrent_fifo_queue<int>(size_t(n));
+  REQUIRE(queue.capacity() >= size_t(n));
+  n = int(queue.capacity());
+  for (int i = 0; i < n; ++i) {
+    queue.push(i);
+  }
+  REQUIRE(queue.try_push(n) == false);
+  for (int i = 0; i < n; ++i) {
+    REQUIRE(int(queue.size()) == n - i);
+    REQUIRE(queue.empty() == false);
+    REQUIRE(queue.pop() == i);
+  }
+  REQUIRE(int(queue.size()) == 0);
+  REQUIRE(queue.empty() == true);
+  REQUIRE(queue.try_pop().has_value() == false);
+}
+
+TEST_CASE("concurrent lifo queue", "[queues]") {
+  int n = GENERATE(10, 100, 1000);
+  auto queue = mooutils::concurrent_lifo_queue<int>(size_t(n));
+  for (int i = 0; i < n; ++i) {
+    queue.push(i);
+  }
+  REQUIRE(queue.try_push(n) == false);
+  for (int i = 0; i < n; ++i) {
+    REQUIRE(int(queue.size()) == n - i);
+    REQUIRE(queue.empty() == false);
+    REQUIRE(queue.pop() == n - i - 1);
+  }
+  REQUIRE(int(queue.size()) == 0);
+  REQUIRE(queue.empty() == true);
+  REQUIRE(queue.try_pop().has_value() == false);
+}
+
+// Several producers push distinct values into a small queue, such that
+// it is often full, while several consumers pop them. Every value must
+// be popped exactly once.
+TEMPLATE_TEST_CASE("concurrent queues with threads", "[queues]", mooutils::concurrent_fifo_queue<int>,
+                   mooutils::concurrent_lifo_queue<int>) {
+  constexpr int threads = 4;
+  constexpr int n = 20000;
+  auto queue = TestType(16);
+  auto popped = std::vector<std::vector<int>>(threads);
+  auto workers = std::vector<std::thread>();
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&queue, t] {
+      for (int i = t; i < n; i += threads) {
+        queue.push(i);
+      }
+    });
+    workers.emplace_back([&queue, &popped, t] {
+      for (int i = t; i < n; i += threads) {
+        popped[size_t(t)].push_back(queue.pop());
+      }
+    });
+  }
+  for (auto &w : workers) {
+    w.join();
+  }
+
+  auto values = std::vector<int>();
+  for (auto const &p : popped) {
+    values.insert(values.end(), p.begin(), p.end());
+  }
+  std::ranges::sort(values);
+  auto expected = std::vector<int>(n);
+  std::iota(expected.begin(), expected.end(), 0);
+  REQUIRE(values == expected);
+  REQUIRE(queue.empty() == true);
+}
+
+TEST_CASE("work stealing queue", "[queues]") {
+  int n = GENERATE(10, 100, 1000);
+  auto queue = mooutils::work_stealing_queue<int>();
+  for (int i = 0; i < n; ++i) {
+    queue.push(i);
+  }
+  // The owner pops the newest solutions, while thieves steal the oldest
+  for (int i = 0; i < n / 2; ++i) {
+    REQUIRE(int(queue.size()) == n - 2 * i);
+    REQUIRE(queue.pop() == n - i - 1);
+    REQUIRE(queue.steal() == i);
+  }
+  REQUIRE(int(queue.size()) == 0);
+  REQUIRE(queue.empty() == true);
+  REQUIRE(queue.try_pop().has_value() == false);
+  REQUIRE(queue.steal().has_value() == false);
+}
+
+// Explores a complete binary tree of n nodes, where each node pushes
+// its children, such that the workers must steal from each other to
+// share the work. Every node must be explored exactly once, and every
+// worker must stop.
+TEST_CASE("work stealing pool", "[queues]") {
+  size_t workers = GENERATE(1, 2, 4);
+  constexpr int n = 100000;
+  auto pool = mooutils::work_stealing_pool<int>(workers);
+  pool.queue(0).push(0);
+
+  auto explored = std::vector<std::vector<int>>(workers);
+  auto threads = std::vector<std::thread>();
+  for (size_t w = 0; w < workers; ++w) {
+    threads.emplace_back([&pool, &explored, w] {
+      while (auto s = pool.next(w)) {
+        explored[w].push_back(*s);
+        for (int c = 2 * *s + 1; c <= 2 * *s + 2 && c < n; ++c) {
+          pool.queue(w).push(c);
+        }
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  auto values = std::vector<int>();
+  for (auto const &e : explored) {
+    values.insert(values.end(), e.begin(), e.end());
+  }
+  std::ranges::sort(values);
+  auto expected = std::vector<int>(n);
+  std::iota(expected.begin(), expected.end(), 0);
+  REQUIRE(values == expected);
+  REQUIRE(pool.size() == 0);
+}
@@ -0,0 +1,45 @@
+#include <catch2/catch.hpp>
+
+#include <mooutils/random.hpp>
+
+#include <random>
+
+static_assert(std::uniform_random_bit_generator<mooutils::xoshiro256plusplus>);
+
+TEST_CASE("xoshiro256plusplus", "[random]") {
+  // First output of the reference implementation for the state {1, 2, 3, 4}
+  auto rng = mooutils::xoshiro256plusplus({1, 2, 3, 4});
+  REQUIRE(rng() == 41943041);
+
+  // Same seed and stream, same sequence
+  auto seed = GENERATE(take(5, random(0, 1000000)));
+  auto rng1 = mooutils::xoshiro256plusplus(static_cast<uint64_t>(seed));
+  auto rng2 = mooutils::xoshiro256plusplus(static_cast<uint64_t>(seed));
+  rng1.discard(100);
+  for (int i = 0; i < 100; ++i) {
+    rng2();
+  }
+  REQUIRE(rng1 == rng2);
+  REQUIRE(rng1() == rng2());
+
+  // Reseeding restarts the sequence
+  auto first = mooutils::xoshiro256plusplus(static_cast<uint64_t>(seed))();
+  rng1.seed(static_cast<uint64_t>(seed));
+  REQUIRE(rng1() == first);
+
+  // Streams are given by jumps
+  auto stream0 = mooutils::xoshiro256plusplus(static_cast<uint64_t>(seed), 0);
+  auto stream2 = mooutils::xoshiro256plusplus(static_cast<uint64_t>(seed), 2);
+  REQUIRE(stream0 != stream2);
+  stream0.jump();
+  stream0.jump();
+  REQUIRE(stream0 == stream2);
+}
+
+TEST_CASE("xoshiro256plusplus constant evaluated", "[random]") {
+  constexpr auto value = [] {
+    auto rng = mooutils::xoshiro256plusplus({1, 2, 3, 4});
+    return rng();
+  }();
+  STATIC_REQUIRE(value == 41943041);
+}
@@ -5,12 +5,17 @@
 #include <mooutils/solution.hpp>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
 #include <deque>
 #include <list>
+#include <numeric>
 #include <random>
 #include <ranges>
 #include <set>
+#include <span>
+#include <thread>
 #include <typeinfo>
 #include <vector>
 
@@ -170,8 +175,13 @@ TEMPLATE_LIST_TEST_CASE("multisets with equivalent solutions", "[sets][template]
 }
 
 using sets_types = std::tuple<mooutils::unordered_minimal_set<solution_type>,  // noformat
-                              mooutils::flat_minimal_set<solution_type>,       // noformat
-                              mooutils::minimal_set<solution_type>>;
+                              mooutils::unordered_minimal_set<solution_type, mooutils::dominance_block<solution_type>>,
+                              mooutils::flat_minimal_set<solution_type>,  // noformat
+                              mooutils::flat_minimal_set<solution_type, mooutils::lexicographically_greater_fn,
+                                                         mooutils::dominance_block<solution_type>>,
+                              mooutils::minimal_set<solution_type>,            // noformat
+                              mooutils::nd_tree_minimal_set<solution_type>,    // noformat
+                              mooutils::quad_tree_minimal_set<solution_type>>;
 
 TEMPLATE_LIST_TEST_CASE("sets with random solutions", "[sets][template]", sets_types) {
   std::random_device rd("/dev/urandom");
@@ -248,3 +258,341 @@ TEMPLATE_LIST_TEST_CASE("sets with equivalent solutions", "[sets][template]", se
   REQUIRE(set.size() == 1);
   REQUIRE(std::ranges::equal(set, ndom_solutions) == true);
 }
+
+// The trees refer to the solutions by iterator, so they need containers
+// with stable iterators.
+static_assert(mooutils::is_node_container<std::list<ovec_type>>);
+static_assert(!mooutils::is_node_container<std::vector<ovec_type>>);
+static_assert(!mooutils::is_node_container<std::deque<ovec_type>>);
+
+using tree_sets_types = std::tuple<mooutils::nd_tree_minimal_set<ovec_type>,  // noformat
+                                   mooutils::quad_tree_minimal_set<ovec_type>>;
+
+TEMPLATE_LIST_TEST_CASE("tree sets erase and copy", "[sets][template]", tree_sets_types) {
+  std::mt19937 rng(42);
+
+  size_t n = GENERATE(10, 100, 1000);
+  size_t m = GENERATE(2, 3, 5, 7);
+
+  auto points = generate_prob_nondominated_points<data_type>(n, m, 0.5, rng);
+  auto set = TestType();
+  for (auto const &p : points) {
+    set.insert(p);
+  }
+
+  // Erase every other point, after which the remaining points and the
+  // erased ones that are not dominated by them are kept
+  auto copy = set;
+  auto erased = std::vector<ovec_type>();
+  for (auto it = set.begin(); it != set.end();) {
+    erased.push_back(*it);
+    it = set.erase(it);
+    if (it != set.end()) {
+      ++it;
+    }
+  }
+  REQUIRE(set.size() + erased.size() == copy.size());
+  for (auto const &p : erased) {
+    REQUIRE(*set.insert(p) == p);
+  }
+  REQUIRE(set.size() == copy.size());
+
+  auto aux1 = std::vector(set.begin(), set.end());
+  auto aux2 = std::vector(copy.begin(), copy.end());
+  std::ranges::sort(aux1);
+  std::ranges::sort(aux2);
+  REQUIRE(aux1 == aux2);
+
+  // The copy is independent of the original set
+  set.erase(set.begin(), set.end());
+  REQUIRE(set.empty());
+  for (auto const &p : points) {
+    REQUIRE(copy.insert(p) == copy.end());
+  }
+  REQUIRE(copy.size() == aux2.size());
+}
+
+static_assert(std::bidirectional_iterator<mooutils::blocked_vector<ovec_type>::iterator>);
+static_assert(std::bidirectional_iterator<mooutils::blocked_vector<ovec_type>::const_iterator>);
+
+// Small blocks, such that they are often split and erased
+using sets2d_types =
+    std::tuple<mooutils::minimal_set2d<ovec_type>,  // noformat
+               mooutils::minimal_set2d<ovec_type, mooutils::lexicographically_greater_fn,
+                                       mooutils::blocked_vector<ovec_type, 4>>,  // noformat
+               mooutils::minimal_set2d<ovec_type, mooutils::lexicographically_greater_fn, std::vector<ovec_type>>>;
+
+TEMPLATE_LIST_TEST_CASE("minimal set 2d", "[sets][template]", sets2d_types) {
+  std::mt19937 rng(42);
+
+  size_t n = GENERATE(10, 100, 1000);
+  int high = GENERATE(5, 50, 5000);
+
+  // Small integer values, such that there are many ties and duplicates
+  std::uniform_int_distribution<int> runif(0, high);
+  auto points = std::vector<ovec_type>();
+  for (size_t i = 0; i < n; ++i) {
+    points.push_back(ovec_type{data_type(runif(rng)), data_type(runif(rng))});
+  }
+
+  auto set = TestType();
+  auto expected = mooutils::flat_minimal_set<ovec_type>();
+  for (auto const &p : points) {
+    auto it = set.insert(p);
+    auto jt = expected.insert(p);
+    if (jt == expected.end()) {
+      REQUIRE(it == set.end());
+    } else {
+      REQUIRE(*it == p);
+    }
+    REQUIRE(std::ranges::equal(set, expected));
+    REQUIRE(set.size() == expected.size());
+  }
+
+  // Erase all but the first and last solutions, one by one
+  while (set.size() > 2) {
+    auto it = set.erase(std::next(set.begin()));
+    REQUIRE(it == std::next(set.begin()));
+    expected.erase(std::next(expected.begin()));
+    REQUIRE(std::ranges::equal(set, expected));
+  }
+}
+
+// Objective vectors of a static size select the two objective case of
+// the set at compile time.
+TEMPLATE_TEST_CASE_SIG("sets with static size", "[sets]", ((size_t M), M), 2, 3) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> runif(0, 20);
+
+  auto set = mooutils::set<std::array<data_type, M>>();
+  auto expected = mooutils::flat_minimal_set<ovec_type>();
+  for (size_t i = 0; i < 1000; ++i) {
+    auto p = std::array<data_type, M>();
+    std::ranges::generate(p, [&] { return data_type(runif(rng)); });
+    set.insert(p);
+    expected.insert(ovec_type(p.begin(), p.end()));
+  }
+  REQUIRE(set.size() == expected.size());
+  REQUIRE(std::ranges::equal(set, expected, std::ranges::equal_to{}, [](auto const &p) {
+    return ovec_type(p.begin(), p.end());
+  }));
+}
+
+// Small integer values, such that there are many ties and equivalent
+// vectors, and sizes around multiples of the chunk size.
+TEMPLATE_TEST_CASE("dominance block", "[sets]", int8_t, int32_t, int64_t, float, double) {
+  std::mt19937 rng(42);
+
+  size_t n = GENERATE(1, 63, 64, 65, 200);
+  size_t m = GENERATE(1, 2, 3, 5, 7, 17);
+
+  std::uniform_int_distribution<int> runif(0, 3);
+  auto points = std::vector<std::vector<TestType>>(n, std::vector<TestType>(m));
+  for (auto &p : points) {
+    std::ranges::generate(p, [&] { return static_cast<TestType>(runif(rng)); });
+  }
+
+  // Insert at random positions, and erase some of them
+  auto block = mooutils::dominance_block<std::vector<TestType>>();
+  auto expected = std::vector<std::vector<TestType>>();
+  for (auto const &p : points) {
+    auto i = std::uniform_int_distribution<size_t>(0, expected.size())(rng);
+    block.emplace(std::next(block.begin(), static_cast<std::ptrdiff_t>(i)), p);
+    expected.insert(std::next(expected.begin(), static_cast<std::ptrdiff_t>(i)), p);
+    if (runif(rng) == 0) {
+      i = std::uniform_int_distribution<size_t>(0, expected.size() - 1)(rng);
+      block.erase(std::next(block.begin(), static_cast<std::ptrdiff_t>(i)));
+      expected.erase(std::next(expected.begin(), static_cast<std::ptrdiff_t>(i)));
+    }
+  }
+  REQUIRE(std::ranges::equal(block, expected));
+
+  auto bit = [](auto const &mask, size_t i) { return ((mask[i / 64] >> (i % 64)) & 1U) != 0; };
+  for (auto const &v : points) {
+    auto q = block.query(v);
+    REQUIRE(q.dominated == std::ranges::any_of(expected, [&v](auto const &p) { return mooutils::dominates(p, v); }));
+    for (size_t i = 0; i < expected.size(); ++i) {
+      REQUIRE(bit(q.dominates, i) == mooutils::dominates(v, expected[i]));
+      REQUIRE(bit(q.equivalent, i) == mooutils::equivalent(v, expected[i]));
+    }
+
+    block.erase_marked(q.dominates);
+    std::erase_if(expected, [&v](auto const &p) { return mooutils::dominates(v, p); });
+    REQUIRE(std::ranges::equal(block, expected));
+  }
+}
+
+TEST_CASE("nondominated filter", "[sets]") {
+  std::mt19937 rng(42);
+
+  size_t n = GENERATE(1, 10, 100, 1000);
+  size_t m = GENERATE(2, 3, 5, 7);
+  double p = GENERATE(0.0, 0.5, 1.0);
+
+  // Duplicate some of the points, such that there are equivalent ones
+  auto points = generate_prob_nondominated_points<data_type>(n, m, p, rng);
+  auto rbern = std::bernoulli_distribution(0.2);
+  for (size_t i = 0; i < n; ++i) {
+    if (rbern(rng)) {
+      points.push_back(points[i]);
+    }
+  }
+  std::ranges::shuffle(points, rng);
+
+  auto expected = std::vector<size_t>();
+  for (size_t i = 0; i < points.size(); ++i) {
+    if (std::ranges::none_of(points, [&](auto const &q) { return mooutils::dominates(q, points[i]); })) {
+      expected.push_back(i);
+    }
+  }
+  REQUIRE(mooutils::nondominated_filter(points) == expected);
+}
+
+// Points with few distinct values, such that there are many ties in
+// each objective
+TEST_CASE("nondominated filter ties", "[sets]") {
+  std::mt19937 rng(42);
+
+  size_t n = GENERATE(10, 100, 2000);
+  size_t m = GENERATE(3, 4, 6);
+  int k = GENERATE(2, 5, 50);
+
+  auto runif = std::uniform_int_distribution<int>(0, k);
+  auto points = std::vector<std::vector<int>>(n, std::vector<int>(m));
+  for (auto &p : points) {
+    std::ranges::generate(p, [&] { return runif(rng); });
+    // Keep most points close to a front
+    auto const sum = std::accumulate(p.begin(), p.end(), 0);
+    p.back() += static_cast<int>(m) * k - sum;
+  }
+
+  auto expected = std::vector<size_t>();
+  for (size_t i = 0; i < points.size(); ++i) {
+    if (std::ranges::none_of(points, [&](auto const &q) { return mooutils::dominates(q, points[i]); })) {
+      expected.push_back(i);
+    }
+  }
+  REQUIRE(mooutils::nondominated_filter(points) == expected);
+}
+
+using all_sets_types = std::tuple<mooutils::unordered_set<solution_type>,          // noformat
+                                  mooutils::flat_set<solution_type>,               // noformat
+                                  mooutils::set<solution_type>,                    // noformat
+                                  mooutils::unordered_minimal_set<solution_type>,  // noformat
+                                  mooutils::flat_minimal_set<solution_type>,       // noformat
+                                  mooutils::flat_minimal_set<solution_type, mooutils::lexicographically_greater_fn,
+                                                             mooutils::dominance_block<solution_type>>,
+                                  mooutils::minimal_set<solution_type>,            // noformat
+                                  mooutils::nd_tree_minimal_set<solution_type>,    // noformat
+                                  mooutils::quad_tree_minimal_set<solution_type>>;
+
+TEMPLATE_LIST_TEST_CASE("sets insert range", "[sets][template]", all_sets_types) {
+  std::mt19937 rng(42);
+
+  size_t n = GENERATE(10, 100, 1000);
+  size_t m = GENERATE(2, 3, 5, 7);
+  double p = GENERATE(0.3, 0.7);
+
+  auto points = generate_prob_nondominated_points<data_type>(n, m, p, rng);
+  auto solutions = std::vector<solution_type>();
+  for (size_t i = 0; i < n; ++i) {
+    solutions.emplace_back(dvec_type{i}, points[i]);
+  }
+  auto first_half = std::vector(solutions.begin(), solutions.begin() + static_cast<std::ptrdiff_t>(n / 2));
+  auto second_half = std::list(solutions.begin() + static_cast<std::ptrdiff_t>(n / 2), solutions.end());
+
+  // Merging into a non-empty set, from both random access and other
+  // ranges, gives the same set as inserting one by one
+  auto expected = TestType();
+  for (auto const &s : solutions) {
+    expected.insert(s);
+  }
+  auto set = TestType();
+  set.insert_range(first_half);
+  set.insert_range(std::move(second_half));
+
+  auto cmp = [](auto const &lhs, auto const &rhs) {
+    return lhs.decision_vector() < rhs.decision_vector();
+  };
+  auto aux1 = std::vector(set.begin(), set.end());
+  auto aux2 = std::vector(expected.begin(), expected.end());
+  std::ranges::sort(aux1, cmp);
+  std::ranges::sort(aux2, cmp);
+  REQUIRE(aux1 == aux2);
+
+  // Solutions are copied, not moved, from rvalue views
+  auto copy = solutions;
+  auto from_span = TestType();
+  from_span.insert_range(std::span(copy));
+  REQUIRE(copy == solutions);
+  auto from_view = TestType();
+  from_view.insert_range(std::views::all(copy));
+  REQUIRE(copy == solutions);
+  auto aux3 = std::vector(from_span.begin(), from_span.end());
+  auto aux4 = std::vector(from_view.begin(), from_view.end());
+  std::ranges::sort(aux3, cmp);
+  std::ranges::sort(aux4, cmp);
+  REQUIRE(aux3 == aux2);
+  REQUIRE(aux4 == aux2);
+}
+
+// Several threads insert random solutions at once while another one
+// takes snapshots, which must always be minimal sets, and the final
+// snapshot must be the minimal set of all the solutions.
+TEST_CASE("concurrent minimal set", "[sets]") {
+  size_t threads = GENERATE(1, 4);
+  size_t m = GENERATE(2, 3);
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> runif(0, 100);
+  auto points = std::vector<ovec_type>(20000, ovec_type(m));
+  for (auto &p : points) {
+    std::ranges::generate(p, [&] { return data_type(runif(rng)); });
+  }
+
+  auto set = mooutils::concurrent_minimal_set<ovec_type>(threads);
+  auto done = std::atomic<bool>(false);
+  auto minimal = std::atomic<bool>(true);
+  auto reader = std::thread([&] {
+    while (!done.load()) {
+      auto snapshot = set.snapshot();
+      for (auto const &a : *snapshot) {
+        for (auto const &b : *snapshot) {
+          if (mooutils::dominates(a, b)) {
+            minimal = false;
+          }
+        }
+      }
+    }
+  });
+  auto writers = std::vector<std::thread>();
+  for (size_t t = 0; t < threads; ++t) {
+    writers.emplace_back([&, t] {
+      for (size_t i = t; i < points.size(); i += threads) {
+        set.insert(points[i]);
+      }
+    });
+  }
+  for (auto &w : writers) {
+    w.join();
+  }
+  done = true;
+  reader.join();
+  REQUIRE(minimal);
+
+  auto expected = mooutils::flat_minimal_set<ovec_type>();
+  for (auto const &p : points) {
+    expected.insert(p);
+  }
+  auto snapshot = set.snapshot();
+  auto result = std::vector<ovec_type>(snapshot->begin(), snapshot->end());
+  std::ranges::sort(result, mooutils::lexicographically_greater);
+  REQUIRE(std::ranges::equal(result, expected));
+  REQUIRE(set.size() == expected.size());
+
+  // Solutions weakly dominated by the snapshot are rejected
+  REQUIRE_FALSE(set.insert(result.front()));
+  REQUIRE(set.insert(ovec_type(m, data_type(1000))));
+  REQUIRE(set.size() == expected.size());
+  REQUIRE(set.snapshot()->size() == 1);
+  REQUIRE(set.size() == 1);
+}
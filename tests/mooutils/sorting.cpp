@@ -0,0 +1,92 @@
+#include <catch2/catch.hpp>
+
+#include <mooutils/orders.hpp>
+#include <mooutils/sorting.hpp>
+
+#include <limits>
+#include <list>
+#include <random>
+#include <vector>
+
+// Points are generated in a small domain such that there are many
+// equivalent points and points that are equal in some objectives.
+template <typename Rng>
+auto generate_points(size_t n, size_t m, Rng&& rng, int low, int high) {
+  auto dist = std::uniform_int_distribution<int>(low, high);
+  auto points = std::vector<std::vector<int>>(n, std::vector<int>(m));
+  for (auto& p : points) {
+    for (auto& v : p) {
+      v = dist(rng);
+    }
+  }
+  return points;
+}
+
+// Ranks by repeatedly removing the non-dominated points.
+auto brute_force_ranks(std::vector<std::vector<int>> const& points, size_t k) {
+  auto ranks = std::vector<size_t>(points.size(), std::numeric_limits<size_t>::max());
+  for (size_t r = 0, ranked = 0; ranked < points.size(); ++r) {
+    auto front = std::vector<size_t>();
+    for (size_t i = 0; i < points.size(); ++i) {
+      if (ranks[i] != std::numeric_limits<size_t>::max()) {
+        continue;
+      }
+      auto dominated = false;
+      for (size_t j = 0; j < points.size() && !dominated; ++j) {
+        dominated = ranks[j] >= r && mooutils::dominates(points[j], points[i]);
+      }
+      if (!dominated) {
+        front.push_back(i);
+      }
+    }
+    for (auto i : front) {
+      ranks[i] = r;
+    }
+    ranked += front.size();
+  }
+  for (auto& r : ranks) {
+    r = std::min(r, k);
+  }
+  return ranks;
+}
+
+TEST_CASE("nondominated sort", "[sorting]") {
+  auto m = GENERATE(range(size_t{1}, size_t{7}));
+  auto n = GENERATE(size_t{0}, size_t{1}, size_t{10}, size_t{100}, size_t{1000});
+  auto high = GENERATE(3, 20, 1000);
+  auto seed = GENERATE(take(3, random(0, 1000000)));
+  auto rng = std::mt19937_64(static_cast<uint64_t>(seed));
+  auto points = generate_points(n, m, rng, 0, high);
+
+  auto k = GENERATE(size_t{1}, size_t{3}, std::numeric_limits<size_t>::max());
+  auto expected = brute_force_ranks(points, k);
+
+  REQUIRE(mooutils::nondominated_sort(points, k) == expected);
+  REQUIRE(mooutils::nondominated_sort_dc(points, k) == expected);
+  REQUIRE(mooutils::nondominated_sort_ens_ss(points, k) == expected);
+  REQUIRE(mooutils::nondominated_sort_ens_bs(points, k) == expected);
+}
+
+TEST_CASE("nondominated sort solutions", "[sorting]") {
+  auto rng = std::mt19937_64(42);
+  auto points = generate_points(500, 3, rng, 0, 50);
+  auto solutions = std::vector<mooutils::unconstrained_solution<std::vector<int>, std::vector<int>>>();
+  for (size_t i = 0; i < points.size(); ++i) {
+    solutions.emplace_back(std::vector<int>{static_cast<int>(i)}, points[i]);
+  }
+
+  REQUIRE(mooutils::nondominated_sort(solutions) == brute_force_ranks(points, std::numeric_limits<size_t>::max()));
+}
+
+TEST_CASE("nondominated sort forward range", "[sorting]") {
+  auto rng = std::mt19937_64(7);
+  auto points = generate_points(300, 4, rng, 0, 20);
+  auto list = std::list<std::vector<int>>(points.begin(), points.end());
+
+  for (auto k : {size_t{1}, size_t{10}, std::numeric_limits<size_t>::max()}) {
+    auto const expected = brute_force_ranks(points, k);
+    REQUIRE(mooutils::nondominated_sort(list, k) == expected);
+    REQUIRE(mooutils::nondominated_sort_dc(list, k) == expected);
+    REQUIRE(mooutils::nondominated_sort_ens_bs(list, k) == expected);
+  }
+}